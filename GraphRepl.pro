@@ -1,56 +1,102 @@
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    codeeditor.cpp \
-    environment.cpp \
-    evaluator.cpp \
-    lambda.cpp \
-    linenumberarea.cpp \
-    lisphighlighter.cpp \
-    listobject.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    primitive.cpp \
-    tokenstream.cpp \
-    utils.cpp \
-    value.cpp
-
-HEADERS += \
-    codeeditor.h \
-    environment.h \
-    evaluator.h \
-    lambda.h \
-    linenumberarea.h \
-    lisphighlighter.h \
-    listobject.h \
-    mainwindow.h \
-    primitive.h \
-    tokenstream.h \
-    utils.h \
-    value.h
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-DISTFILES += \
-    .gitignore \
-    GraphRepl.pro.user \
-    LICENSE \
-    README.md \
-    doc/basic_check.md \
-    doc/basic_primitive.md \
-    doc/math.md \
-    doc/system.md \
-    doc/type_check.md \
-    img/screenshot_0.jpg \
-    init.scm
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+# Numbers are double by default. Uncomment to compute in long double
+# (x87 80-bit): more precise, but several times slower for sin/cos/pow.
+#DEFINES += GRAPHREPL_LONG_DOUBLE
+
+# Plot kernels use AVX2 when the compiler targets it. Uncomment to enable it
+# for x86-64 builds (the binary will then not run on CPUs without AVX2).
+#QMAKE_CXXFLAGS += -mavx2
+
+# On x86-64 Unix, plot kernels are compiled to native code at runtime.
+# Uncomment to always evaluate them with the portable loops instead.
+#DEFINES += GRAPHREPL_NO_JIT
+
+SOURCES += \
+    astarena.cpp \
+    codeeditor.cpp \
+    compiler.cpp \
+    constantfolder.cpp \
+    environment.cpp \
+    evaluator.cpp \
+    implicitsampler.cpp \
+    jit.cpp \
+    kernel.cpp \
+    lambda.cpp \
+    lexer.cpp \
+    linenumberarea.cpp \
+    lisphighlighter.cpp \
+    listobject.cpp \
+    main.cpp \
+    mainwindow.cpp \
+    plotmanager.cpp \
+    plotrenderer.cpp \
+    plottiles.cpp \
+    plotviewer.cpp \
+    primitive.cpp \
+    resolver.cpp \
+    sampler.cpp \
+    symboltable.cpp \
+    threadpool.cpp \
+    tokenstream.cpp \
+    utils.cpp \
+    value.cpp \
+    vm.cpp
+
+HEADERS += \
+    astarena.h \
+    bytecode.h \
+    codeeditor.h \
+    compiler.h \
+    constantfolder.h \
+    environment.h \
+    evaluator.h \
+    implicitsampler.h \
+    jit.h \
+    kernel.h \
+    lambda.h \
+    lexer.h \
+    linenumberarea.h \
+    lisphighlighter.h \
+    listobject.h \
+    mainwindow.h \
+    number.h \
+    plotmanager.h \
+    plotrenderer.h \
+    plottiles.h \
+    plotviewer.h \
+    primitive.h \
+    resolver.h \
+    sampler.h \
+    symboltable.h \
+    threadpool.h \
+    tokenstream.h \
+    utils.h \
+    value.h \
+    vm.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+DISTFILES += \
+    .gitignore \
+    GraphRepl.pro.user \
+    LICENSE \
+    README.md \
+    doc/basic_check.md \
+    doc/basic_primitive.md \
+    doc/math.md \
+    doc/system.md \
+    doc/type_check.md \
+    img/screenshot_0.jpg \
+    init.scm
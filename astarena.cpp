@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "astarena.h"
+#include "lambda.h"
+#include <cstdint>
+
+AstArena::~AstArena() = default;
+
+void* AstArena::allocate(size_t size, size_t align) {
+    size_t pad = (align - reinterpret_cast<uintptr_t>(cursor) % align) % align;
+    if (!cursor || pad + size > left) {
+        // великий масив отримує власний блок, а поточний блок лишається для дрібних
+        if (size > BytesPerBlock / 4) {
+            blocks.emplace_back(new char[size]);
+            return blocks.back().get();
+        }
+        blocks.emplace_back(new char[BytesPerBlock]);
+        cursor = blocks.back().get();
+        left = BytesPerBlock;
+        pad = 0;
+    }
+
+    char* data = cursor + pad;
+    cursor += pad + size;
+    left -= pad + size;
+    return data;
+}
+
+ListObject* AstArena::nodes(size_t count) {
+    used += count * sizeof(ListObject);
+    return static_cast<ListObject*>(allocate(count * sizeof(ListObject), alignof(ListObject)));
+}
+
+const std::string* AstArena::text(std::string text) {
+    texts.push_back(std::move(text));
+    return &texts.back();
+}
+
+ListObject::Form* AstArena::form() {
+    forms.emplace_back();
+    return &forms.back();
+}
+
+size_t AstArena::nodeBytes() const {
+    return used;
+}
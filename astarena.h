@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef ASTARENA_H
+#define ASTARENA_H
+
+#include "listobject.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Пам'ять AST одного джерела: файлу load-file, скрипту чи введення REPL.
+// Масиви вузлів виразів виділяються зсувом покажчика у великих блоках і
+// звільняються разом з ареною, тож розбір не робить окремого виділення на
+// кожен вузол, а вирази джерела лежать у пам'яті поспіль. Поруч лежать
+// таблиці текстів рядків і чисел та даних форм LAMBDA і BEGIN.
+// Арену тримає shared_ptr: той, хто виконує джерело, і кожне замикання,
+// створене з його форм LAMBDA (див. LambdaPrototype::arena).
+class AstArena
+{
+public:
+    AstArena() = default;
+    ~AstArena();
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    // суцільний масив з count вузлів, ще не створених
+    ListObject* nodes(size_t count);
+    // текст у таблиці рядків
+    const std::string* text(std::string text);
+    // новий запис у таблиці форм
+    ListObject::Form* form();
+
+    // скільки байтів займають масиви вузлів
+    size_t nodeBytes() const;
+
+private:
+    static const size_t BytesPerBlock = 32 * 1024;
+
+    void* allocate(size_t size, size_t align);
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t left = 0;
+    size_t used = 0;
+    std::deque<std::string> texts;
+    std::deque<ListObject::Form> forms;
+};
+
+#endif // ASTARENA_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "value.h"
+#include <cstdint>
+#include <vector>
+
+// Байткод: опкод та його операнди займають по одному 32-бітному слову
+enum class OpCode : std::uint32_t {
+    Const,          // k               -> constants[k]
+    Local,          // depth slot      -> значення слота кадру
+    Global,         // symbol          -> пошук за іменем
+    DefineLocal,    // slot            значення лишається на стеку
+    DefineGlobal,   // symbol          значення лишається на стеку
+    Pop,
+    Jump,           // target
+    JumpIfFalse,    // target          знімає значення, перехід якщо це FALSE
+    JumpIfTrue,     // target          знімає значення, перехід якщо це TRUE
+    EnterFrame,     // node            новий кадр BEGIN
+    LeaveFrame,
+    Closure,        // node            замикання над поточним середовищем
+    Call,           // argc            функція та аргументи на стеку
+    TailCall,       // argc            як Call, але замінює кадр поточної лямбди
+    Builtin,        // symbol argc     строгий примітив над значеннями зі стеку
+    Primitive,      // node first      лінивий примітив, отримує вузли аргументів;
+                    //                 їх байткод - arguments[first...]
+    Fail,           // k               помилка з повідомленням constants[k]
+    Return
+};
+
+struct Chunk
+{
+    std::vector<std::uint32_t> code;
+    std::vector<Value> constants;
+    std::vector<ListObject*> nodes; // вузли в арені; її тримає власник chunk (див. Lambda::getCode)
+    // аргументи лінивих примітивів, скомпільовані разом з chunk: примітив
+    // обчислює їх через Evaluator::Eval, і VM не компілює їх на кожному виклику
+    std::vector<std::shared_ptr<const Chunk>> arguments;
+};
+
+#endif // BYTECODE_H
@@ -1,30 +1,30 @@
-#ifndef CODEEDITOR_H
-#define CODEEDITOR_H
-
-#include <QPlainTextEdit>
-#include <QSyntaxHighlighter>
-
-class CodeEditor : public QPlainTextEdit
-{
-    Q_OBJECT
-
-public:
-    CodeEditor(QWidget *parent = nullptr);
-
-    void lineNumberAreaPaintEvent(QPaintEvent *event);
-    int lineNumberAreaWidth();
-
-protected:
-    void resizeEvent(QResizeEvent *event) override;
-
-private slots:
-    void updateLineNumberAreaWidth(int newBlockCount);
-    void highlightCurrentLine();
-    void updateLineNumberArea(const QRect &rect, int dy);
-
-private:
-    QWidget *lineNumberArea;
-    QSyntaxHighlighter *highlighter;
-};
-
-#endif // CODEEDITOR_H
+#ifndef CODEEDITOR_H
+#define CODEEDITOR_H
+
+#include <QPlainTextEdit>
+#include <QSyntaxHighlighter>
+
+class CodeEditor : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    CodeEditor(QWidget *parent = nullptr);
+
+    void lineNumberAreaPaintEvent(QPaintEvent *event);
+    int lineNumberAreaWidth();
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void updateLineNumberAreaWidth(int newBlockCount);
+    void highlightCurrentLine();
+    void updateLineNumberArea(const QRect &rect, int dy);
+
+private:
+    QWidget *lineNumberArea;
+    QSyntaxHighlighter *highlighter;
+};
+
+#endif // CODEEDITOR_H
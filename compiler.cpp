@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "compiler.h"
+#include "evaluator.h"
+#include "utils.h"
+
+Compiler::Compiler(Evaluator& eval) : eval(eval) {}
+
+std::shared_ptr<const Chunk> Compiler::compile(ListObject* exp) {
+    chunk = std::make_shared<Chunk>();
+    expr(exp);
+    emitOp(OpCode::Return);
+    return chunk;
+}
+
+std::shared_ptr<const Chunk> Compiler::compileBody(Lambda& lambda) {
+    chunk = std::make_shared<Chunk>();
+    const auto& forms = lambda.getBody();
+
+    for (size_t i = 0; i < forms.size(); ++i) {
+        if (i > 0)
+            emitOp(OpCode::Pop);
+        expr(forms[i], i + 1 == forms.size());
+    }
+
+    emitOp(OpCode::Return);
+    return chunk;
+}
+
+void Compiler::expr(ListObject* exp, bool tail) {
+    if (exp->isAtom()) {
+        atom(exp);
+        return;
+    }
+
+    if (isLambda(exp)) {
+        emitOp(OpCode::Closure, node(exp));
+        return;
+    }
+
+    if (isBegin(exp)) {
+        begin(exp, tail);
+        return;
+    }
+
+    if (isCond(exp)) {
+        cond(exp->asList(), tail);
+        return;
+    }
+
+    const auto& list = exp->asList();
+    if (list.empty()) {
+        fail("No found type");
+        return;
+    }
+
+    const auto& head = list[0];
+    if (head->isAtom() && eval.isPrimitive(head->asSymbol())) {
+        Symbol name = head->asSymbol();
+        if (name == Sym::DEFINE)
+            define(list);
+        else if (name == Sym::AND || name == Sym::OR)
+            logic(list, name == Sym::AND);
+        else if (!builtin(list))
+            primitive(exp);
+        return;
+    }
+
+    application(list, tail);
+}
+
+void Compiler::atom(ListObject* exp) {
+    switch (exp->atomType()) {
+    case ListObject::AtomType::Number:
+        emitOp(OpCode::Const, constant(Value(exp->asNumber())));
+        break;
+    case ListObject::AtomType::Boolean:
+        emitOp(OpCode::Const, constant(Value(exp->asBoolean())));
+        break;
+    case ListObject::AtomType::String:
+        emitOp(OpCode::Const, constant(Value(std::string(exp->asAtom()))));
+        break;
+    case ListObject::AtomType::Symbol:
+        if (exp->slot() >= 0)
+            emitOp(OpCode::Local, exp->depth(), exp->slot());
+        else
+            emitOp(OpCode::Global, exp->asSymbol());
+        break;
+    }
+}
+
+void Compiler::begin(ListObject* exp, bool tail) {
+    const auto& list = exp->asList();
+    if (list.size() < 2) {
+        fail("'begin': at least one argument is required");
+        return;
+    }
+
+    emitOp(OpCode::EnterFrame, node(exp));
+    for (size_t i = 1; i < list.size(); ++i) {
+        if (i > 1)
+            emitOp(OpCode::Pop);
+        expr(list[i], tail && i + 1 == list.size());
+    }
+    emitOp(OpCode::LeaveFrame);
+}
+
+void Compiler::define(const ListObject::List& list) {
+    if (list.size() != 3) {
+        fail("'define' requires exactly 2 arguments: (define name value)");
+        return;
+    }
+
+    const auto& name = list[1];
+    if (!name->isAtom() || name->atomType() != ListObject::AtomType::Symbol) {
+        fail("'define' first argument must be a symbol");
+        return;
+    }
+
+    expr(list[2]);
+    if (name->slot() >= 0)
+        emitOp(OpCode::DefineLocal, name->slot());
+    else
+        emitOp(OpCode::DefineGlobal, name->asSymbol());
+}
+
+void Compiler::cond(const ListObject::List& list, bool tail) {
+    if (list.size() < 2) {
+        fail("'cond': at least one argument is required");
+        return;
+    }
+
+    std::vector<size_t> exits;
+    for (size_t i = 1; i < list.size(); ++i) {
+        const auto& clause = list[i];
+        if (clause->isAtom()) {
+            fail("'cond': each clause must be a list");
+            break;
+        }
+
+        const auto& inner = clause->asList();
+        if (inner.empty()) {
+            fail("'cond': clause must not be empty");
+            break;
+        }
+
+        const auto& condition = inner[0];
+        if (condition->isAtom() && condition->asSymbol() == Sym::ELSE) {
+            if (inner.size() < 2) {
+                fail("'cond': 'else' clause must have a body");
+                break;
+            }
+            expr(inner[1], tail);
+            exits.push_back(emitJump(OpCode::Jump));
+            break;
+        }
+
+        expr(condition);
+        size_t next = emitJump(OpCode::JumpIfFalse);
+        if (inner.size() < 2)
+            fail("'cond': true condition must have a body");
+        else
+            expr(inner[1], tail);
+        exits.push_back(emitJump(OpCode::Jump));
+        patchJump(next);
+    }
+
+    emitOp(OpCode::Const, constant(Value()));
+    for (size_t at : exits)
+        patchJump(at);
+}
+
+void Compiler::logic(const ListObject::List& list, bool isAnd) {
+    if (list.size() < 2) {
+        fail("'and': at least one argument is required");
+        return;
+    }
+
+    std::vector<size_t> shortCircuits;
+    for (size_t i = 1; i < list.size(); ++i) {
+        expr(list[i]);
+        shortCircuits.push_back(emitJump(isAnd ? OpCode::JumpIfFalse : OpCode::JumpIfTrue));
+    }
+
+    emitOp(OpCode::Const, constant(Value(isAnd)));
+    size_t end = emitJump(OpCode::Jump);
+    for (size_t at : shortCircuits)
+        patchJump(at);
+    emitOp(OpCode::Const, constant(Value(!isAnd)));
+    patchJump(end);
+}
+
+bool Compiler::builtin(const ListObject::List& list) {
+    Symbol name = list[0]->asSymbol();
+    const Evaluator::PrimitiveInfo& primitive = eval.getPrimitive(name);
+    if (!primitive.strict)
+        return false;
+
+    size_t argc = list.size() - 1;
+    if (!primitive.acceptsArity(argc)) {
+        fail(primitive.arityError);
+        return true;
+    }
+
+    for (size_t i = 1; i < list.size(); ++i)
+        expr(list[i]);
+    emitOp(OpCode::Builtin, name, static_cast<std::uint32_t>(argc));
+    return true;
+}
+
+void Compiler::primitive(ListObject* exp) {
+    const auto list = exp->asList();
+    auto first = static_cast<std::uint32_t>(chunk->arguments.size());
+    for (size_t i = 1; i < list.size(); ++i)
+        chunk->arguments.push_back(Compiler(eval).compile(list[i]));
+    emitOp(OpCode::Primitive, node(exp), first);
+}
+
+void Compiler::application(const ListObject::List& list, bool tail) {
+    for (const auto& item : list)
+        expr(item);
+    emitOp(tail ? OpCode::TailCall : OpCode::Call, static_cast<std::uint32_t>(list.size() - 1));
+}
+
+void Compiler::emitOp(OpCode op) {
+    chunk->code.push_back(static_cast<std::uint32_t>(op));
+}
+
+void Compiler::emitOp(OpCode op, std::uint32_t operand) {
+    emitOp(op);
+    chunk->code.push_back(operand);
+}
+
+void Compiler::emitOp(OpCode op, std::uint32_t a, std::uint32_t b) {
+    emitOp(op, a);
+    chunk->code.push_back(b);
+}
+
+size_t Compiler::emitJump(OpCode op) {
+    emitOp(op, 0);
+    return chunk->code.size() - 1;
+}
+
+void Compiler::patchJump(size_t at) {
+    chunk->code[at] = static_cast<std::uint32_t>(chunk->code.size());
+}
+
+std::uint32_t Compiler::constant(const Value& value) {
+    chunk->constants.push_back(value);
+    return static_cast<std::uint32_t>(chunk->constants.size() - 1);
+}
+
+std::uint32_t Compiler::node(ListObject* exp) {
+    chunk->nodes.push_back(exp);
+    return static_cast<std::uint32_t>(chunk->nodes.size() - 1);
+}
+
+void Compiler::fail(const std::string& message) {
+    emitOp(OpCode::Fail, constant(Value(message)));
+}
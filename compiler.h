@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "bytecode.h"
+#include <string>
+
+class Evaluator;
+
+// Перекладає дерево ListObject у байткод для VM.
+// Форми, яких компілятор не знає, виконуються через звичайні примітиви.
+class Compiler
+{
+public:
+    Compiler(Evaluator& eval);
+
+    std::shared_ptr<const Chunk> compile(ListObject* exp);
+    std::shared_ptr<const Chunk> compileBody(Lambda& lambda);
+
+private:
+    // tail - вираз у хвостовій позиції тіла лямбди, виклик тут не потребує нового кадру VM
+    void expr(ListObject* exp, bool tail = false);
+    void atom(ListObject* exp);
+    void begin(ListObject* exp, bool tail);
+    void define(const ListObject::List& list);
+    void cond(const ListObject::List& list, bool tail);
+    void logic(const ListObject::List& list, bool isAnd);
+    bool builtin(const ListObject::List& list);
+    void primitive(ListObject* exp);
+    void application(const ListObject::List& list, bool tail);
+
+    void emitOp(OpCode op);
+    void emitOp(OpCode op, std::uint32_t operand);
+    void emitOp(OpCode op, std::uint32_t a, std::uint32_t b);
+    size_t emitJump(OpCode op);
+    void patchJump(size_t at);
+    std::uint32_t constant(const Value& value);
+    std::uint32_t node(ListObject* exp);
+    void fail(const std::string& message);
+
+    Evaluator& eval;
+    std::shared_ptr<Chunk> chunk;
+};
+
+#endif // COMPILER_H
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "constantfolder.h"
+#include "astarena.h"
+#include "evaluator.h"
+#include "resolver.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <sstream>
+
+namespace {
+
+// значення атома-літерала; false для символу чи списку
+bool literalValue(const ListObject* exp, Value& value) {
+    if (!exp->isAtom())
+        return false;
+
+    switch (exp->atomType()) {
+    case ListObject::AtomType::Number:
+        value = Value(exp->asNumber());
+        return true;
+    case ListObject::AtomType::Boolean:
+        value = Value(exp->asBoolean());
+        return true;
+    case ListObject::AtomType::String:
+        value = Value(std::string(exp->asAtom()));
+        return true;
+    case ListObject::AtomType::Symbol:
+        break;
+    }
+    return false;
+}
+
+bool isSymbol(const ListObject* exp, Symbol name) {
+    return exp->isAtom() && exp->atomType() == ListObject::AtomType::Symbol && exp->asSymbol() == name;
+}
+
+// текст згорнутого числа для print та звіту
+std::string numberText(Number value) {
+    std::ostringstream out;
+    out.precision(std::numeric_limits<Number>::digits10);
+    out << value;
+    return out.str();
+}
+
+}
+
+ConstantFolder::ConstantFolder(const Evaluator& eval, AstArena& arena) : eval(eval), arena(arena) {}
+
+void ConstantFolder::fold(const std::vector<ListObject*>& forms, std::ostream* report) {
+    for (ListObject* form : forms)
+        countDefines(form, false);
+
+    for (ListObject* form : forms) {
+        changed = false;
+        foldExpr(form);
+        if (report && changed) {
+            *report << "fold: ";
+            form->print(*report);
+            *report << "\n";
+        }
+
+        // (define name літерал) верхнього рівня - константа для наступних форм,
+        // якщо інших глобальних DEFINE цього імені в джерелі немає
+        if (loadsFiles || form->isAtom())
+            continue;
+
+        const auto list = form->asList();
+        if (list.size() == 3 && isSymbol(list[0], Sym::DEFINE)
+            && list[1]->isAtom() && list[1]->atomType() == ListObject::AtomType::Symbol
+            && globalDefines[list[1]->asSymbol()] == 1 && list[2]->isAtom()
+            && (list[2]->atomType() == ListObject::AtomType::Number || list[2]->atomType() == ListObject::AtomType::Boolean))
+            constants[list[1]->asSymbol()] = list[2];
+    }
+}
+
+void ConstantFolder::countDefines(ListObject* exp, bool local) {
+    static const Symbol LoadFile = SymbolTable::intern("LOAD-FILE");
+
+    const auto list = exp->asList();
+    if (list.empty())
+        return;
+
+    // LOAD-FILE може перевизначити будь-яку глобальну, де б його не викликали
+    if (isSymbol(list[0], LoadFile))
+        loadsFiles = true;
+    if (!local && list.size() > 1 && isSymbol(list[0], Sym::DEFINE)
+        && list[1]->isAtom() && list[1]->atomType() == ListObject::AtomType::Symbol)
+        ++globalDefines[list[1]->asSymbol()];
+
+    // DEFINE у тілі LAMBDA чи BEGIN визначає локальну змінну їхнього кадру
+    local = local || isLambda(exp) || isBegin(exp);
+    for (ListObject* item : list)
+        countDefines(item, local);
+}
+
+void ConstantFolder::foldExpr(ListObject* exp) {
+    if (exp->isAtom()) {
+        if (exp->atomType() == ListObject::AtomType::Symbol)
+            substitute(exp);
+        return;
+    }
+
+    const auto list = exp->asList();
+    if (list.empty())
+        return;
+
+    if (isLambda(exp)) {
+        std::vector<Symbol> names;
+        if (list.size() > 1)
+            for (ListObject* param : list[1]->asList())
+                names.push_back(param->asSymbol());
+        ++lambdaDepth;
+        foldScope(list, 2, std::move(names));
+        --lambdaDepth;
+        return;
+    }
+
+    if (isBegin(exp)) {
+        foldScope(list, 1, {});
+        return;
+    }
+
+    if (isCond(exp)) {
+        // клауза - не виклик: згортаються лише її умова й тіло
+        for (size_t i = 1; i < list.size(); ++i)
+            for (ListObject* item : list[i]->asList())
+                if (!isSymbol(item, Sym::ELSE))
+                    foldExpr(item);
+        return;
+    }
+
+    ListObject* head = list[0];
+    if (!head->isAtom()) {
+        for (ListObject* item : list)
+            foldExpr(item);
+        return;
+    }
+
+    // голова лишається як є, а ім'я в DEFINE - не значення
+    for (size_t i = isSymbol(head, Sym::DEFINE) ? 2 : 1; i < list.size(); ++i)
+        foldExpr(list[i]);
+
+    if (head->atomType() == ListObject::AtomType::Symbol && eval.isPrimitive(head->asSymbol())
+        && eval.getPrimitive(head->asSymbol()).strict)
+        foldCall(exp);
+}
+
+void ConstantFolder::foldScope(const ListObject::List& forms, size_t first, std::vector<Symbol> names) {
+    Resolver::collectDefines(forms, first, names);
+    scopes.push_back(std::move(names));
+    for (size_t i = first; i < forms.size(); ++i)
+        foldExpr(forms[i]);
+    scopes.pop_back();
+}
+
+void ConstantFolder::foldCall(ListObject* exp) {
+    const auto list = exp->asList();
+    Symbol head = list[0]->asSymbol();
+    const auto& primitive = eval.getPrimitive(head);
+    const auto args = list.from(1);
+
+    // помилку кількості аргументів кине виконання, як і без згортання
+    if (!primitive.acceptsArity(args.size()))
+        return;
+
+    for (ListObject* arg : args) {
+        if (!arg->isAtom() || arg->atomType() == ListObject::AtomType::Symbol) {
+            dropIdentities(exp, head);
+            return;
+        }
+    }
+
+    std::vector<Value> values(args.size());
+    for (size_t i = 0; i < args.size(); ++i)
+        literalValue(args[i], values[i]);
+
+    Value result;
+    try {
+        primitive.checkTypes(values.data(), values.size());
+        result = primitive.strict(values.data(), values.size());
+    } catch (const std::exception&) {
+        return;
+    }
+
+    if (result.isNumber())
+        exp->setNumber(result.asNumber(), arena.text(numberText(result.asNumber())));
+    else if (result.isBool())
+        exp->setBoolean(result.asBool());
+    else
+        return;
+    changed = true;
+}
+
+void ConstantFolder::dropIdentities(ListObject* exp, Symbol head) {
+    static const Symbol Plus = SymbolTable::intern("+");
+    static const Symbol Minus = SymbolTable::intern("-");
+    static const Symbol Mul = SymbolTable::intern("*");
+    static const Symbol Div = SymbolTable::intern("/");
+
+    // нейтральний елемент і перший аргумент, з якого його можна прибрати:
+    // у - та / перший аргумент особливий, (- x) - це вже -x
+    Number identity;
+    size_t first;
+    if (head == Plus || head == Minus) {
+        identity = 0;
+        first = head == Plus ? 1 : 2;
+    } else if (head == Mul || head == Div) {
+        identity = 1;
+        first = head == Mul ? 1 : 2;
+    } else {
+        return;
+    }
+
+    // -0 не нейтральний: x - -0 дає 0 там, де x = -0
+    auto isIdentity = [identity](const ListObject* arg) {
+        return arg->isAtom() && arg->atomType() == ListObject::AtomType::Number
+            && arg->asNumber() == identity && !std::signbit(arg->asNumber());
+    };
+
+    auto list = exp->asList();
+    size_t keep = 0;
+    ListObject* last = nullptr;
+    for (size_t i = 1; i < list.size(); ++i) {
+        if (i < first || !isIdentity(list[i])) {
+            ++keep;
+            last = list[i];
+        }
+    }
+    if (keep == list.size() - 1)
+        return;
+
+    // виклик з одним аргументом замінюється ним самим, лише якщо це число:
+    // інакше лишається перевірка типу. (+ x) лишається і для числа, бо 0 + -0 = 0
+    bool collapse = keep == 1 && head != Plus && isNumeric(last);
+    if (keep == 1 && first == 2 && !collapse)
+        return;
+
+    for (size_t i = list.size() - 1; i >= first; --i)
+        if (isIdentity(list[i]))
+            exp->removeChild(i);
+
+    if (collapse)
+        exp->assign(*exp->asList()[1]);
+    changed = true;
+}
+
+void ConstantFolder::substitute(ListObject* atom) {
+    // тіло лямбди читає змінну під час виклику, а не під час завантаження
+    if (constants.empty() || lambdaDepth > 0)
+        return;
+
+    Symbol name = atom->asSymbol();
+    auto constant = constants.find(name);
+    if (constant == constants.end())
+        return;
+
+    // параметр чи локальна змінна з тим самим іменем затуляє глобальну
+    for (const auto& scope : scopes)
+        if (std::find(scope.begin(), scope.end(), name) != scope.end())
+            return;
+
+    atom->assign(*constant->second);
+    changed = true;
+}
+
+bool ConstantFolder::isNumeric(const ListObject* exp) const {
+    if (exp->isAtom())
+        return exp->atomType() == ListObject::AtomType::Number;
+
+    const auto list = exp->asList();
+    if (list.empty() || !list[0]->isAtom() || list[0]->atomType() != ListObject::AtomType::Symbol)
+        return false;
+
+    Symbol head = list[0]->asSymbol();
+    return eval.isPrimitive(head) && eval.getPrimitive(head).strict
+        && eval.getPrimitive(head).resultType == Evaluator::PrimitiveInfo::Type::Number;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef CONSTANTFOLDER_H
+#define CONSTANTFOLDER_H
+
+#include "listobject.h"
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+class AstArena;
+class Evaluator;
+
+// Згортання констант: прохід над розібраними формами одного джерела перед
+// Resolver, тож вирази на кшталт (* 2 3.14159) у тілі лямбди не обчислюються
+// на кожній точці графіка. Вузли переписуються на місці в масиві арени.
+//  - Виклик строгого примітиву з літеральними аргументами замінюється його
+//    результатом; виклик, що кидає помилку, лишається й кидає її під час виконання.
+//  - (+ x 0), (* x 1), (- x 0), (/ x 1) втрачають зайві аргументи; сам x
+//    лишається замість виклику, лише якщо це напевно число, інакше виклик
+//    зберігає перевірку типу.
+//  - Глобальна константа, яку джерело визначає рівно раз формою верхнього
+//    рівня (define name літерал), підставляється в наступні форми джерела,
+//    але не в тіла лямбд: лямбда виконується пізніше, коли REPL уже міг
+//    перевизначити змінну. Джерело з LOAD-FILE констант не підставляє.
+// Голова виклику завжди лишається символом: примітив у ній виконується, навіть
+// якщо DEFINE визначив змінну з тим самим іменем, тож така змінна підставляється
+// лише як значення, як і будь-яка інша глобальна.
+class ConstantFolder
+{
+public:
+    ConstantFolder(const Evaluator& eval, AstArena& arena);
+
+    // forms - усі форми джерела в порядку виконання; якщо задано report,
+    // кожна змінена форма друкується туди після згортання
+    void fold(const std::vector<ListObject*>& forms, std::ostream* report = nullptr);
+
+private:
+    void countDefines(ListObject* exp, bool local);
+    void foldExpr(ListObject* exp);
+    void foldScope(const ListObject::List& forms, size_t first, std::vector<Symbol> names);
+    void foldCall(ListObject* exp);
+    void dropIdentities(ListObject* exp, Symbol head);
+    void substitute(ListObject* atom);
+    bool isNumeric(const ListObject* exp) const;
+
+    const Evaluator& eval;
+    AstArena& arena;
+
+    std::unordered_map<Symbol, int> globalDefines;       // DEFINE поза кадрами LAMBDA та BEGIN
+    std::unordered_map<Symbol, const ListObject*> constants; // ім'я -> вузол-літерал
+    std::vector<std::vector<Symbol>> scopes;             // локальні імена охоплюючих кадрів
+    int lambdaDepth = 0;                                 // вкладеність тіл LAMBDA
+    bool loadsFiles = false;
+    bool changed = false;
+};
+
+#endif // CONSTANTFOLDER_H
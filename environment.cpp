@@ -1,65 +1,142 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "environment.h"
-#include <stdexcept>
-
-Environment::Environment() : parent(nullptr) {}
-Environment::~Environment() {
-    //std::cout << "End of ENV" << std::endl;
-}
-
-Environment::Environment(Ptr parentEnv) : parent(parentEnv) {}
-
-void Environment::define(const std::string& name, const Value& value) {
-    map[name] = value;
-    
-}
-
-bool Environment::set(const std::string& name, const Value& value) {
-    if (map.count(name)) {
-        map[name] = value;
-        return true;
-    } else if (parent) {
-        return parent->set(name, value);
-    }
-    return false;
-}
-
-Value Environment::get(const std::string& name) const {
-    auto it = map.find(name);
-    if (it != map.end()) {
-        return it->second;
-    } else if (parent) {
-        return parent->get(name);
-    } else {
-        throw std::runtime_error("Variable not found: " + name);
-    }
-}
-
-bool Environment::has(const std::string& name) const {
-    if (map.count(name)) {
-        return true;
-    } else if (parent) {
-        return parent->has(name);
-    }
-    return false;
-}
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "environment.h"
+#include <stdexcept>
+
+Environment::Environment() : parent(nullptr) {}
+Environment::~Environment() {
+    //std::cout << "End of ENV" << std::endl;
+}
+
+Environment::Environment(Ptr parentEnv) : parent(parentEnv) {}
+
+Environment::Environment(Ptr parentEnv, std::shared_ptr<const std::vector<Symbol>> names) : parent(std::move(parentEnv)), slotNames(std::move(names)) {
+    if (slotNames)
+        slotValues.reserve(slotNames->size());
+}
+
+void Environment::define(Symbol name, const Value& value) {
+    map[name] = value;
+}
+
+bool Environment::set(Symbol name, const Value& value) {
+    auto it = map.find(name);
+    if (it != map.end()) {
+        it->second = value;
+        return true;
+    } else if (parent) {
+        return parent->set(name, value);
+    }
+    return false;
+}
+
+Value Environment::get(Symbol name) const {
+    Value value;
+    if (!find(name, value))
+        throw std::runtime_error("Variable not found: " + SymbolTable::name(name));
+    return value;
+}
+
+bool Environment::find(Symbol name, Value& value) const {
+    for (const Environment* env = this; env; env = env->parent.get()) {
+        for (size_t i = 0; i < env->slotValues.size(); ++i) {
+            if ((*env->slotNames)[i] == name) {
+                if (env->slotValues[i].isUnbound())
+                    return false;
+                value = env->slotValue(i);
+                return true;
+            }
+        }
+
+        auto it = env->map.find(name);
+        if (it != env->map.end()) {
+            value = it->second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Environment::defineSlot(int slot, const Value& value) {
+    if (static_cast<size_t>(slot) >= slotValues.size())
+        slotValues.resize(slot + 1, Value::unbound());
+
+    if (value.isLambda()) {
+        auto lambda = value.asLambda();
+        if (lambda->getEnv().get() == this) {
+            slotValues[slot] = Value(lambda->withEnv(nullptr));
+            return;
+        }
+    }
+    slotValues[slot] = value;
+}
+
+Value Environment::slotValue(size_t slot) const {
+    const Value& value = slotValues[slot];
+    if (!value.isLambda())
+        return value;
+
+    auto lambda = value.asLambda();
+    if (lambda->getEnv())
+        return value;
+    return Value(lambda->withEnv(std::const_pointer_cast<Environment>(shared_from_this())));
+}
+
+const Environment::Ptr& Environment::getParent() const {
+    return parent;
+}
+
+std::shared_mutex& Environment::globalLock() {
+    static std::shared_mutex lock;
+    return lock;
+}
+
+namespace {
+
+std::atomic<int> waitingWriters{0};
+
+}
+
+Environment::WriteLock::WriteLock() {
+    ++waitingWriters;
+    lock = std::unique_lock<std::shared_mutex>(globalLock());
+    --waitingWriters;
+}
+
+bool Environment::writerWaiting() {
+    return waitingWriters.load(std::memory_order_relaxed) > 0;
+}
+
+Value Environment::lookup(int depth, int slot) const {
+    const Environment* env = this;
+    while (depth-- > 0)
+        env = env->parent.get();
+
+    if (static_cast<size_t>(slot) >= env->slotValues.size() || env->slotValues[slot].isUnbound())
+        throw std::runtime_error("Variable not found: " + SymbolTable::name((*env->slotNames)[slot]));
+    return env->slotValue(slot);
+}
+
+bool Environment::has(Symbol name) const {
+    Value value;
+    return find(name, value);
+}
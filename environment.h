@@ -1,50 +1,87 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef ENVIRONMENT_H
-#define ENVIRONMENT_H
-
-#include "value.h"
-#include "mainwindow.h"
-#include <string>
-#include <map>
-
-class Environment
-{
-public:
-    using Ptr = std::shared_ptr<Environment>;
-    friend void MainWindow::updateTable();
-
-    Environment();
-    ~Environment();
-    Environment(Ptr parent);
-
-    void define(const std::string& name, const Value& value);
-    bool set(const std::string& name, const Value& value);
-    Value get(const std::string& name) const;
-    bool has(const std::string& name) const;
-
-private:
-    Ptr parent;
-    std::map<std::string, Value> map;
-};
-
-#endif // ENVIRONMENT_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include "value.h"
+#include "mainwindow.h"
+#include "symboltable.h"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// Замикання тримає кадр, у якому його створено, а кадр - свої змінні. Якщо
+// замикання зберігається (DEFINE) у слоті саме цього кадру, shared_ptr утворили б
+// цикл, тому слот тримає замикання без середовища, а lookup і find повертають
+// його знову прив'язаним до кадру. Так кадр звільняється разом з останнім
+// власником, хоч би в якому потоці це сталося.
+class Environment : public std::enable_shared_from_this<Environment>
+{
+public:
+    using Ptr = std::shared_ptr<Environment>;
+    friend void MainWindow::updateTable();
+
+    Environment();
+    ~Environment();
+    Environment(Ptr parent);
+    // Кадр LAMBDA чи BEGIN: змінні зберігаються у масиві слотів
+    Environment(Ptr parent, std::shared_ptr<const std::vector<Symbol>> names);
+
+    void define(Symbol name, const Value& value);
+    bool set(Symbol name, const Value& value);
+    Value get(Symbol name) const;
+    bool find(Symbol name, Value& value) const;
+    bool has(Symbol name) const;
+
+    void defineSlot(int slot, const Value& value);
+    Value lookup(int depth, int slot) const;
+
+    const Ptr& getParent() const;
+
+    // Середовище REPL змінюється під унікальним замком, а фонові потоки вікон
+    // графіків обчислюють функції під спільним, тож не бачать його напівзміненим
+    static std::shared_mutex& globalLock();
+
+    // Унікальний замок REPL. Поки він очікується, writerWaiting() повертає true,
+    // і фонова вибірка переривається між шматками точок та звільняє спільний
+    // замок, тож REPL не чекає на обчислення цілої плитки
+    class WriteLock
+    {
+    public:
+        WriteLock();
+    private:
+        std::unique_lock<std::shared_mutex> lock;
+    };
+    static bool writerWaiting();
+
+private:
+    Value slotValue(size_t slot) const;
+
+    Ptr parent;
+    std::unordered_map<Symbol, Value> map;
+    std::vector<Value> slotValues;
+    std::shared_ptr<const std::vector<Symbol>> slotNames;
+};
+
+#endif // ENVIRONMENT_H
@@ -1,167 +1,316 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "evaluator.h"
-#include "environment.h"
-#include "utils.h"
-#include "primitive.h"
-
-Value Evaluator::Eval(std::shared_ptr<ListObject> exp, std::shared_ptr<Environment> env) {
-    if (isNumber(exp)) { // is number
-        return Value(std::stold(exp->asAtom()));
-    } else if (isBoolean(exp)) { // is boolean
-        std::string token = exp->asAtom();
-        if (token == "TRUE")
-            return Value(true);
-        else
-            return Value(false);
-    } else if (isString(exp)) { // is string
-        return Value(exp->asAtom());
-    } else if (isVariable(exp, env)) { // is variable
-        Value result = Value(env->get(exp->asAtom()));
-        return result;
-    } if (isLambda(exp)) {
-        auto lambdaList = exp->asList();
-        auto paramsListObj = lambdaList[1];
-
-        std::vector<std::string> args;
-        for (auto& param : paramsListObj->asList()) {
-            args.push_back(param->asAtom());
-        }
-
-        std::vector<std::shared_ptr<ListObject>> bodyExprs(
-            lambdaList.begin() + 2, lambdaList.end()
-            );
-        auto bodyList = std::make_shared<ListObject>(bodyExprs);
-
-        auto lambda = std::make_shared<Lambda>(args, bodyList);
-        return Value(lambda);
-    } else if(isApplication(exp, env, *this)) { // is application
-        const auto& list = exp->asList();
-        std::shared_ptr<ListObject> funcExp = list[0];
-
-        std::vector<std::shared_ptr<ListObject>> args;
-        for (size_t i = 1; i < list.size(); ++i)
-            args.push_back(list[i]);
-
-        return Apply(funcExp, args, env, *this);
-    } else {
-        throw std::runtime_error("No found type");
-    }
-
-    return Value();
-}
-
-Value Evaluator::Apply(std::shared_ptr<ListObject> proccedure, std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (proccedure->isAtom() && eval.isPrimitive(proccedure->asAtom())) {
-        auto prim = eval.getPrimitive(proccedure->asAtom());
-        Value result = prim(args, env, eval);
-        return result;
-    } else {
-        auto lambda = eval.Eval(proccedure, env);
-        auto procArgs = lambda.asLambda()->getArgs();
-        auto procBody = lambda.asLambda()->getBody();
-        std::shared_ptr<Environment> newEnv = std::make_shared<Environment>(env);
-        for (size_t i = 0; i < procArgs.size(); ++i) {
-            std::string argName = procArgs[i];
-            Value argValue = eval.Eval(args[i], env);
-            newEnv->define(argName, argValue);
-        }
-        Value result;
-        if (!procBody->isAtom() && procBody->asList().size() >= 1) {
-            for (auto& expr : procBody->asList()) {
-                result = eval.Eval(expr, newEnv);
-            }
-            return result;
-        } else {
-            return eval.Eval(procBody, newEnv);
-        }
-        return result;
-    }
-}
-
-Value Evaluator::ApplyLambda(std::shared_ptr<Lambda> lambda, std::vector<Value> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    auto procArgs = lambda->getArgs();
-    auto procBody = lambda->getBody();
-    std::shared_ptr<Environment> newEnv = std::make_shared<Environment>(env);
-    for (size_t i = 0; i < procArgs.size(); ++i) {
-        std::string argName = procArgs[i];
-        Value argValue = args[i];
-        newEnv->define(argName, argValue);
-    }
-    Value result;
-    if (!procBody->isAtom() && procBody->asList().size() >= 1) {
-        for (auto& expr : procBody->asList()) {
-            result = eval.Eval(expr, newEnv);
-        }
-        return result;
-    } else {
-        return eval.Eval(procBody, newEnv);
-    }
-    return result;
-}
-
-Evaluator::Evaluator() {
-    primitives["DEFINE"] = Primitive::std_define;
-    primitives["BEGIN"] = Primitive::std_begin;
-    primitives["COND"] = Primitive::std_cond;
-
-    primitives["="] =  Primitive::std_equal;
-    primitives[">"] =  Primitive::std_gt;
-    primitives["<"] =  Primitive::std_lt;
-    primitives[">="] =  Primitive::std_ge;
-    primitives["<="] =  Primitive::std_le;
-    primitives["AND"] = Primitive::std_and;
-    primitives["OR"] = Primitive::std_or;
-    primitives["NOT"] = Primitive::std_not;
-    primitives["NUMBER?"] = Primitive::std_is_number;
-    primitives["STRING?"] = Primitive::std_is_string;
-    primitives["BOOL?"] = Primitive::std_is_bool;
-    primitives["LAMBDA?"] = Primitive::std_is_lambda;
-
-    primitives["+"] = Primitive::std_plus;
-    primitives["-"] = Primitive::std_minus;
-    primitives["*"] = Primitive::std_mul;
-    primitives["/"] = Primitive::std_div;
-    primitives["SQRT"] = Primitive::std_sqrt;
-    primitives["POW"] = Primitive::std_pow;
-    primitives["SIN"] = Primitive::std_sin;
-    primitives["COS"] = Primitive::std_cos;
-    primitives["TAN"] = Primitive::std_tan;
-    primitives["ASIN"] = Primitive::std_asin;
-    primitives["ACOS"] = Primitive::std_acos;
-    primitives["ATAN"] = Primitive::std_atan;
-
-    primitives["EXIT"] = Primitive::std_exit;
-    primitives["LOAD-FILE"] = Primitive::std_load_file;
-    primitives["DRAW-PLOT"] = Primitive::std_draw_plot;
-}
-
-bool Evaluator::isPrimitive(const std::string& name) const {
-    return primitives.find(name) != primitives.end();
-}
-
-std::function<Value(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval)> Evaluator::getPrimitive(const std::string& name) const {
-    auto it = primitives.find(name);
-    if (it == primitives.end())
-        throw std::runtime_error(" Unknown primitive: " + name);
-    return it->second;
-}
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "evaluator.h"
+#include "environment.h"
+#include "utils.h"
+#include "primitive.h"
+
+Value Evaluator::Eval(ListObject* exp, std::shared_ptr<Environment> env) {
+    if (backend == Backend::VM)
+        return vm.eval(exp, std::move(env), *this);
+
+    // хвостові позиції виконуються наступною ітерацією циклу, а не рекурсією,
+    // тож хвостова рекурсія працює в сталій пам'яті та глибині стеку
+    // лямбда, тіло якої зараз виконується: тримає арену з його вузлами,
+    // навіть якщо саме тіло перевизначить змінну з цією лямбдою
+    std::shared_ptr<Lambda> current;
+
+    for (;;) {
+        if (exp->isAtom()) {
+            switch (exp->atomType()) {
+            case ListObject::AtomType::Number:
+                return Value(exp->asNumber());
+            case ListObject::AtomType::Boolean:
+                return Value(exp->asBoolean());
+            case ListObject::AtomType::String:
+                return Value(std::string(exp->asAtom()));
+            case ListObject::AtomType::Symbol: // is variable
+                if (exp->slot() >= 0)
+                    return env->lookup(exp->depth(), exp->slot());
+                if (Value value; env->find(exp->asSymbol(), value))
+                    return value;
+                throw std::runtime_error("Variable not found: " + std::string(exp->asAtom()));
+            }
+        }
+
+        if (isLambda(exp)) {
+            return Value(MakeLambda(exp, env));
+        } else if (isBegin(exp)) {
+            const auto& list = exp->asList();
+            if (list.size() < 2)
+                throw std::runtime_error("'begin': at least one argument is required");
+
+            auto newEnv = std::make_shared<Environment>(env, exp->frame());
+            for (size_t i = 1; i + 1 < list.size(); ++i)
+                Eval(list[i], newEnv);
+
+            // остання форма - хвостова позиція
+            env = std::move(newEnv);
+            exp = list.back();
+            continue;
+        } else if (isCond(exp)) {
+            auto branch = SelectBranch(exp->asList(), env);
+            if (!branch)
+                return Value();
+
+            exp = branch;
+            continue;
+        }
+
+        const auto& list = exp->asList();
+        if (list.empty())
+            throw std::runtime_error("No found type");
+
+        // is application
+        ListObject* funcExp = list[0];
+
+        if (funcExp->isAtom() && isPrimitive(funcExp->asSymbol())) {
+            const PrimitiveInfo& primitive = primitives[funcExp->asSymbol()];
+            if (primitive.lazy)
+                return primitive.lazy(list.from(1), env, *this);
+            return CallStrict(primitive, list.from(1), env);
+        }
+
+        // оператор обчислюється рівно один раз, далі працюємо з його значенням
+        Value procedure = Eval(funcExp, env);
+        if (!procedure.isLambda())
+            throw std::runtime_error("No found type");
+
+        auto lambda = procedure.asLambda();
+        const auto& procArgs = lambda->getArgs();
+        size_t argc = list.size() - 1;
+        if (argc < procArgs.size())
+            throw std::runtime_error("Lambda expects " + std::to_string(procArgs.size()) + " arguments, got " + std::to_string(argc));
+
+        auto newEnv = std::make_shared<Environment>(lambda->getEnv(), lambda->getFrame());
+        for (size_t i = 0; i < procArgs.size(); ++i)
+            newEnv->defineSlot(i, Eval(list[i + 1], env));
+
+        const auto& forms = lambda->getBody();
+        for (size_t i = 0; i + 1 < forms.size(); ++i)
+            Eval(forms[i], newEnv);
+
+        // тіло виконується в цьому ж циклі
+        env = std::move(newEnv);
+        exp = forms.back();
+        current = std::move(lambda);
+    }
+}
+
+Value Evaluator::CallStrict(const PrimitiveInfo& primitive, ListObject::List args, const std::shared_ptr<Environment>& env) {
+    if (!primitive.acceptsArity(args.size()))
+        throw std::runtime_error(primitive.arityError);
+
+    // довші за буфер виклики бувають лише в + - * / і порівняннях
+    constexpr size_t InlineArgs = 4;
+    if (args.size() > InlineArgs) {
+        std::vector<Value> values;
+        values.reserve(args.size());
+        for (ListObject* arg : args)
+            values.push_back(EvalArgument(arg, env));
+        primitive.checkTypes(values.data(), values.size());
+        return primitive.strict(values.data(), values.size());
+    }
+
+    Value values[InlineArgs];
+    for (size_t i = 0; i < args.size(); ++i)
+        values[i] = EvalArgument(args[i], env);
+
+    primitive.checkTypes(values, args.size());
+    return primitive.strict(values, args.size());
+}
+
+Value Evaluator::EvalArgument(ListObject* exp, const std::shared_ptr<Environment>& env) {
+    if (exp->isAtom()) {
+        if (exp->atomType() == ListObject::AtomType::Number)
+            return Value(exp->asNumber());
+        if (exp->atomType() == ListObject::AtomType::Symbol && exp->slot() >= 0)
+            return env->lookup(exp->depth(), exp->slot());
+    }
+    return Eval(exp, env);
+}
+
+ListObject* Evaluator::SelectBranch(const ListObject::List& list, const std::shared_ptr<Environment>& env) {
+    if (list.size() < 2)
+        throw std::runtime_error("'cond': at least one argument is required");
+
+    for (size_t i = 1; i < list.size(); ++i) {
+        const auto& clause = list[i];
+        if (clause->isAtom())
+            throw std::runtime_error("'cond': each clause must be a list");
+
+        const auto& inner = clause->asList();
+        if (inner.empty())
+            throw std::runtime_error("'cond': clause must not be empty");
+
+        const auto& condition = inner[0];
+
+        if (condition->isAtom() && condition->asSymbol() == Sym::ELSE) {
+            if (inner.size() < 2)
+                throw std::runtime_error("'cond': 'else' clause must have a body");
+            return inner[1];
+        }
+
+        Value condResult = Eval(condition, env);
+
+        if (!condResult.isBool() || condResult.asBool()) {
+            if (inner.size() < 2)
+                throw std::runtime_error("'cond': true condition must have a body");
+            return inner[1];
+        }
+    }
+
+    return nullptr;
+}
+
+Value Evaluator::ApplyLambda(std::shared_ptr<Lambda> lambda, std::vector<Value> args, Evaluator& eval) {
+    if (eval.backend == Backend::VM)
+        return eval.vm.call(lambda, args, eval);
+
+    const auto& procArgs = lambda->getArgs();
+    if (args.size() < procArgs.size())
+        throw std::runtime_error("Lambda expects " + std::to_string(procArgs.size()) + " arguments, got " + std::to_string(args.size()));
+    std::shared_ptr<Environment> newEnv = std::make_shared<Environment>(lambda->getEnv(), lambda->getFrame());
+    for (size_t i = 0; i < procArgs.size(); ++i) {
+        newEnv->defineSlot(i, args[i]);
+    }
+    Value result;
+    for (ListObject* expr : lambda->getBody())
+        result = eval.Eval(expr, newEnv);
+    return result;
+}
+
+std::shared_ptr<Lambda> Evaluator::MakeLambda(ListObject* exp, std::shared_ptr<Environment> env) const {
+    LambdaPrototype* proto = exp->prototype();
+    if (!proto)
+        throw std::runtime_error("'lambda': form was not resolved");
+
+    // лямбда без посилань на локальні змінні не тримає кадрів, де її створено
+    if (!exp->capturesLocals())
+        while (env->getParent())
+            env = env->getParent();
+
+    // замикання тримає арену форми, а через неї й прототип
+    return std::make_shared<Lambda>(std::shared_ptr<LambdaPrototype>(proto->arena.lock(), proto), env);
+}
+
+void Evaluator::setBackend(Backend backend) {
+    this->backend = backend;
+}
+
+Evaluator::Backend Evaluator::getBackend() const {
+    return backend;
+}
+
+void Evaluator::setFolding(Folding folding) {
+    this->folding = folding;
+}
+
+Evaluator::Folding Evaluator::getFolding() const {
+    return folding;
+}
+
+void Evaluator::setPlotManager(PlotManager* plots) {
+    this->plots = plots;
+}
+
+PlotManager* Evaluator::getPlotManager() const {
+    return plots;
+}
+
+Evaluator::Evaluator() : primitives(registry()) {}
+
+const Evaluator::Registry& Evaluator::registry() {
+    static const Registry table = makeRegistry();
+    return table;
+}
+
+Evaluator::Registry Evaluator::makeRegistry() {
+    Registry table;
+    using Type = PrimitiveInfo::Type;
+
+    definePrimitive(table, "DEFINE", Primitive::std_define);
+
+    definePrimitive(table, "=", Primitive::std_equal, 2, 2, Type::Any, Type::Boolean, "'=' expects exactly 2 arguments", nullptr);
+    definePrimitive(table, ">", Primitive::std_gt, 0, -1, Type::Number, Type::Boolean, nullptr, "Comparison requires numeric arguments");
+    definePrimitive(table, "<", Primitive::std_lt, 0, -1, Type::Number, Type::Boolean, nullptr, "Comparison requires numeric arguments");
+    definePrimitive(table, ">=", Primitive::std_ge, 0, -1, Type::Number, Type::Boolean, nullptr, "Comparison requires numeric arguments");
+    definePrimitive(table, "<=", Primitive::std_le, 0, -1, Type::Number, Type::Boolean, nullptr, "Comparison requires numeric arguments");
+    definePrimitive(table, "AND", Primitive::std_and);
+    definePrimitive(table, "OR", Primitive::std_or);
+    definePrimitive(table, "NOT", Primitive::std_not, 1, 1, Type::Any, Type::Boolean, "'not' expects exactly 1 arguments", nullptr);
+    definePrimitive(table, "NUMBER?", Primitive::std_is_number, 1, 1, Type::Any, Type::Boolean, "'number?': requires exactly 1 argument", nullptr);
+    definePrimitive(table, "STRING?", Primitive::std_is_string, 1, 1, Type::Any, Type::Boolean, "'string?': requires exactly 1 argument", nullptr);
+    definePrimitive(table, "BOOL?", Primitive::std_is_bool, 1, 1, Type::Any, Type::Boolean, "'bool?': requires exactly 1 argument", nullptr);
+    definePrimitive(table, "LAMBDA?", Primitive::std_is_lambda, 1, 1, Type::Any, Type::Boolean, "'lambda?': requires exactly 1 argument", nullptr);
+
+    definePrimitive(table, "+", Primitive::std_plus, 0, -1, Type::Number, Type::Number, nullptr, " '+' only works with numbers");
+    definePrimitive(table, "-", Primitive::std_minus, 1, -1, Type::Number, Type::Number, "'-': at least one argument is required", "'-': all arguments must be numbers");
+    definePrimitive(table, "*", Primitive::std_mul, 0, -1, Type::Number, Type::Number, nullptr, " '*' only works with numbers");
+    definePrimitive(table, "/", Primitive::std_div, 1, -1, Type::Number, Type::Number, "'/' expects at least one argument", "'/' expects all arguments to be numbers");
+    definePrimitive(table, "SQRT", Primitive::std_sqrt, 1, 1, Type::Number, Type::Number, "'sqrt': requires exactly 1 argument", "'sqrt': argument must be a number");
+    definePrimitive(table, "POW", Primitive::std_pow, 2, 2, Type::Number, Type::Number, "'pow': requires exactly 2 arguments", "'pow': both arguments must be numbers");
+    definePrimitive(table, "SIN", Primitive::std_sin, 1, 1, Type::Number, Type::Number, "'sin': requires exactly 1 argument", "'sin': argument must be a number");
+    definePrimitive(table, "COS", Primitive::std_cos, 1, 1, Type::Number, Type::Number, "'cos': requires exactly 1 argument", "'cos': argument must be a number");
+    definePrimitive(table, "TAN", Primitive::std_tan, 1, 1, Type::Number, Type::Number, "'tan': requires exactly 1 argument", "'tan': argument must be a number");
+    definePrimitive(table, "ASIN", Primitive::std_asin, 1, 1, Type::Number, Type::Number, "'asin': requires exactly 1 argument", "'asin': argument must be a number");
+    definePrimitive(table, "ACOS", Primitive::std_acos, 1, 1, Type::Number, Type::Number, "'acos': requires exactly 1 argument", "'acos': argument must be a number");
+    definePrimitive(table, "ATAN", Primitive::std_atan, 1, 1, Type::Number, Type::Number, "'atan': requires exactly 1 argument", "'atan': argument must be a number");
+
+    definePrimitive(table, "EXIT", Primitive::std_exit);
+    definePrimitive(table, "LOAD-FILE", Primitive::std_load_file);
+    definePrimitive(table, "DRAW-PLOT", Primitive::std_draw_plot);
+    definePrimitive(table, "DRAW-PLOTS", Primitive::std_draw_plots);
+    definePrimitive(table, "DRAW-PARAMETRIC", Primitive::std_draw_parametric);
+    definePrimitive(table, "DRAW-IMPLICIT", Primitive::std_draw_implicit);
+    definePrimitive(table, "DRAW-PLOT-TO-FILE", Primitive::std_draw_plot_to_file);
+    definePrimitive(table, "SET-BACKEND", Primitive::std_set_backend);
+    definePrimitive(table, "SET-FOLDING", Primitive::std_set_folding);
+    return table;
+}
+
+void Evaluator::definePrimitive(Registry& table, std::string_view name, PrimitiveFunc func) {
+    Symbol id = SymbolTable::intern(name);
+    if (id >= table.size())
+        table.resize(id + 1);
+    table[id] = PrimitiveInfo{};
+    table[id].lazy = func;
+}
+
+void Evaluator::definePrimitive(Registry& table, std::string_view name, StrictFunc func, int minArgs, int maxArgs,
+                                PrimitiveInfo::Type argType, PrimitiveInfo::Type resultType,
+                                const char* arityError, const char* typeError) {
+    Symbol id = SymbolTable::intern(name);
+    if (id >= table.size())
+        table.resize(id + 1);
+    table[id] = PrimitiveInfo{nullptr, func, minArgs, maxArgs, argType, resultType, arityError, typeError};
+}
+
+bool Evaluator::isPrimitive(Symbol name) const {
+    return name < primitives.size() && (primitives[name].lazy || primitives[name].strict);
+}
+
+const Evaluator::PrimitiveInfo& Evaluator::getPrimitive(Symbol name) const {
+    if (!isPrimitive(name))
+        throw std::runtime_error(" Unknown primitive: " + SymbolTable::name(name));
+    return primitives[name];
+}
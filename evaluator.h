@@ -1,48 +1,130 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef EVALUATOR_H
-#define EVALUATOR_H
-
-#include "value.h"
-#include <functional>
-#include <map>
-
-class Environment;
-class Evaluator
-{
-public:
-    Evaluator();
-
-    Value Eval(std::shared_ptr<ListObject> exp, std::shared_ptr<Environment> env);
-    Value Apply(std::shared_ptr<ListObject> proccedure, std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval);
-    Value ApplyLambda(std::shared_ptr<Lambda> lambda, std::vector<Value> args, std::shared_ptr<Environment> env, Evaluator& eval);
-
-    bool isPrimitive(const std::string& name) const;
-    std::function<Value(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval)> getPrimitive(const std::string& name) const;
-
-private:
-    std::map<std::string, std::function<Value(std::vector<std::shared_ptr<ListObject>>, std::shared_ptr<Environment>, Evaluator&)>> primitives;
-
-    void initPrimitives();
-};
-
-#endif // EVALUATOR_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "value.h"
+#include "vm.h"
+#include <stdexcept>
+#include <vector>
+
+class Environment;
+class PlotManager;
+
+class Evaluator
+{
+public:
+    // Tree - обхід дерева, VM - компіляція в байткод і стекова машина
+    enum class Backend { Tree, VM };
+    // згортання констант перед виконанням; Report ще й друкує згорнуті форми
+    enum class Folding { Off, On, Report };
+
+    // Примітив отримує невласний відрізок вузлів аргументів і позичене
+    // середовище виклику: виклик нічого не копіює і не чіпає лічильників посилань
+    using PrimitiveFunc = Value (*)(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval);
+    // Строгий примітив - чиста функція вже обчислених аргументів
+    using StrictFunc = Value (*)(const Value* args, size_t argc);
+
+    // Опис примітиву в реєстрі. Лінивий (DEFINE, AND, OR, draw-* ...) сам
+    // обчислює вузли аргументів. Для строгого кількість аргументів перевіряється
+    // до їх обчислення, а тип - одразу для всіх обчислених значень, тож сама
+    // функція перевірок не повторює. Так само строгі примітиви викликає VM.
+    struct PrimitiveInfo
+    {
+        enum class Type { Any, Number, Boolean };
+
+        PrimitiveFunc lazy = nullptr;
+        StrictFunc strict = nullptr;
+        int minArgs = 0;
+        int maxArgs = -1;             // -1: будь-яка кількість
+        Type argType = Type::Any;     // тип кожного аргументу
+        Type resultType = Type::Any;  // за ним ConstantFolder знає, що (+ x) - число
+        const char* arityError = nullptr;
+        const char* typeError = nullptr;
+
+        bool acceptsArity(size_t argc) const;
+        void checkTypes(const Value* args, size_t argc) const;
+    };
+
+    Evaluator();
+
+    void setBackend(Backend backend);
+    Backend getBackend() const;
+
+    void setFolding(Folding folding);
+    Folding getFolding() const;
+
+    // вікна для draw-plot; nullptr - вікон немає, графіки пишуться у файли
+    void setPlotManager(PlotManager* plots);
+    PlotManager* getPlotManager() const;
+
+    Value Eval(ListObject* exp, std::shared_ptr<Environment> env);
+    Value ApplyLambda(std::shared_ptr<Lambda> lambda, std::vector<Value> args, Evaluator& eval);
+    // замикання над середовищем env, у якому обчислюється форма LAMBDA
+    std::shared_ptr<Lambda> MakeLambda(ListObject* exp, std::shared_ptr<Environment> env) const;
+
+    bool isPrimitive(Symbol name) const;
+    const PrimitiveInfo& getPrimitive(Symbol name) const;
+    // виклик строгого примітиву: аргументи обчислюються в невеликий буфер на стеку
+    Value CallStrict(const PrimitiveInfo& primitive, ListObject::List args, const std::shared_ptr<Environment>& env);
+
+private:
+    Backend backend = Backend::Tree;
+    Folding folding = Folding::On;
+    VM vm;
+    PlotManager* plots = nullptr;
+
+    // аргумент строгого примітиву: числа й локальні змінні читаються на місці,
+    // без рекурсивного Eval з його копією середовища
+    Value EvalArgument(ListObject* exp, const std::shared_ptr<Environment>& env);
+
+    // гілка COND, яку треба виконати, або nullptr, якщо жодна умова не справдилась
+    ListObject* SelectBranch(const ListObject::List& list, const std::shared_ptr<Environment>& env);
+
+    // індексується ID символу, порожній елемент означає відсутність примітиву.
+    // Реєстр незмінний і спільний для всіх Evaluator, тож локальний Evaluator
+    // потоку вибірки створюється без заповнення таблиці
+    using Registry = std::vector<PrimitiveInfo>;
+    const Registry& primitives;
+
+    static const Registry& registry();
+    static Registry makeRegistry();
+    static void definePrimitive(Registry& table, std::string_view name, PrimitiveFunc func);
+    static void definePrimitive(Registry& table, std::string_view name, StrictFunc func, int minArgs, int maxArgs,
+                                PrimitiveInfo::Type argType, PrimitiveInfo::Type resultType,
+                                const char* arityError, const char* typeError);
+};
+
+// перевірки строгого виклику виконуються на кожному кроці, тому вбудовані тут
+
+inline bool Evaluator::PrimitiveInfo::acceptsArity(size_t argc) const {
+    return argc >= static_cast<size_t>(minArgs) && (maxArgs < 0 || argc <= static_cast<size_t>(maxArgs));
+}
+
+inline void Evaluator::PrimitiveInfo::checkTypes(const Value* args, size_t argc) const {
+    if (argType == Type::Number)
+        for (size_t i = 0; i < argc; ++i)
+            if (!args[i].isNumber())
+                throw std::runtime_error(typeError);
+}
+
+#endif // EVALUATOR_H
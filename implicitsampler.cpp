@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "implicitsampler.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+const int CellPx = 8;          // клітинка початкової сітки
+const int MaxDepth = 4;        // найдрібніша клітинка: 8 / 2^4 = пів пікселя
+const int BlockCells = 8;      // блок паралельної обробки: 8x8 клітинок, 64 пікселі
+const int Fine = 1 << MaxDepth;
+const int Steps = BlockCells * Fine;   // кроків найдрібнішої сітки на сторону блоку
+
+// Клітинка блоку: лівий верхній кут і сторона в кроках найдрібнішої сітки
+struct Cell
+{
+    int i;
+    int j;
+    int size;
+};
+
+struct Segment
+{
+    PlotPoint a;
+    PlotPoint b;
+};
+
+// Точка перетину на спільному ребрі сусідніх клітинок (зокрема з різних блоків)
+// рахується з тих самих вузлів, тож кінці їхніх відрізків збігаються до біта
+using PointKey = std::pair<uint64_t, uint64_t>;
+
+struct PointKeyHash
+{
+    size_t operator()(const PointKey& key) const {
+        return std::hash<uint64_t>()(key.first) ^ (std::hash<uint64_t>()(key.second) * 31);
+    }
+};
+
+PointKey keyOf(const PlotPoint& p) {
+    PointKey key;
+    std::memcpy(&key.first, &p.x, sizeof(key.first));
+    std::memcpy(&key.second, &p.y, sizeof(key.second));
+    return key;
+}
+
+// чи може між кутами клітинки пройти f = 0: знак змінюється, або |f| у
+// якомусь куті менше за перепад f у клітинці (вузька петля чи дотик)
+bool nearZero(const double* values) {
+    double min = std::numeric_limits<double>::infinity();
+    double max = -min;
+    double minAbs = min;
+    int finite = 0;
+    for (int k = 0; k < 4; ++k) {
+        if (!std::isfinite(values[k]))
+            continue;
+        ++finite;
+        min = std::min(min, values[k]);
+        max = std::max(max, values[k]);
+        minAbs = std::min(minAbs, std::abs(values[k]));
+    }
+    if (finite < 2)
+        return false;
+    return (min < 0 && max >= 0) || minAbs < max - min;
+}
+
+// відрізки зі спільними кінцями з'єднуються в ламані, розділені точкою з y = NaN
+std::vector<PlotPoint> stitch(const std::vector<Segment>& segments) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::unordered_map<PointKey, std::vector<size_t>, PointKeyHash> ends;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        ends[keyOf(segments[s].a)].push_back(s);
+        ends[keyOf(segments[s].b)].push_back(s);
+    }
+
+    std::vector<bool> used(segments.size(), false);
+    // невикористаний відрізок з кінцем у p додається до лінії; false, якщо такого немає
+    auto extend = [&](const PlotPoint& p, PlotPoint& next) {
+        const PointKey key = keyOf(p);
+        for (size_t s : ends.at(key)) {
+            if (used[s])
+                continue;
+            used[s] = true;
+            next = keyOf(segments[s].a) == key ? segments[s].b : segments[s].a;
+            return true;
+        }
+        return false;
+    };
+
+    std::vector<PlotPoint> lines;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        if (used[s])
+            continue;
+        used[s] = true;
+        std::deque<PlotPoint> line{segments[s].a, segments[s].b};
+        PlotPoint next;
+        while (extend(line.back(), next))
+            line.push_back(next);
+        while (extend(line.front(), next))
+            line.push_front(next);
+
+        if (!lines.empty())
+            lines.push_back({nan, nan});
+        lines.insert(lines.end(), line.begin(), line.end());
+    }
+    return lines;
+}
+
+}
+
+ImplicitSampler::ImplicitSampler(Evaluator& eval, std::shared_ptr<Lambda> function)
+    : backend(eval.getBackend()), function(std::move(function)), kernel(Kernel::compile({this->function}, 2)) {}
+
+void ImplicitSampler::setCancel(std::function<bool()> cancelled) {
+    this->cancelled = std::move(cancelled);
+}
+
+std::vector<PlotPoint> ImplicitSampler::contour(const PlotView& view, bool refine, std::exception_ptr* failure) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const int blockPx = BlockCells * CellPx;
+    const size_t columns = std::max(1, (view.width + blockPx - 1) / blockPx);
+    const size_t rows = std::max(1, (view.height + blockPx - 1) / blockPx);
+    const int maxDepth = refine ? MaxDepth : 0;
+
+    // крок найдрібнішої сітки в координатах функції; вузол задається номером
+    // у сітці всього view, тож спільні вузли сусідніх блоків мають ті самі x, y
+    const double dx = (view.xMax - view.xMin) / view.width * CellPx / Fine;
+    const double dy = (view.yMax - view.yMin) / view.height * CellPx / Fine;
+
+    std::mutex mutex;
+    std::vector<std::vector<Segment>> found(columns * rows);
+    bool sampled = false;
+    size_t errorBlock = found.size();
+    std::exception_ptr error;
+
+    ThreadPool::instance().parallelFor(columns * rows, [&](size_t block) {
+        const long long baseI = static_cast<long long>(block % columns) * Steps;
+        const long long baseJ = static_cast<long long>(block / columns) * Steps;
+        auto xAt = [&](int i) { return view.xMin + static_cast<double>(baseI + i) * dx; };
+        auto yAt = [&](int j) { return view.yMax - static_cast<double>(baseJ + j) * dy; };
+
+        const int side = Steps + 1;
+        std::vector<double> values(side * side, nan);
+        std::vector<bool> known(side * side, false);
+        std::unique_ptr<Evaluator> local;
+        std::exception_ptr blockError;
+        bool blockSampled = false;
+
+        // f у вузлах nodes одним пакетом; точки, де ядро зафіксувало б помилку,
+        // перераховує інтерпретатор, щоб отримати саму помилку
+        auto evaluate = [&](const std::vector<int>& nodes) {
+            if (cancelled && cancelled())
+                throw SamplingCancelled();
+
+            const size_t n = nodes.size();
+            std::vector<double> xs(n), ys(n), fs(n);
+            std::unique_ptr<bool[]> failed(new bool[n]());
+            for (size_t k = 0; k < n; ++k) {
+                xs[k] = xAt(nodes[k] % side);
+                ys[k] = yAt(nodes[k] / side);
+            }
+            if (kernel) {
+                const double* args[] = {xs.data(), ys.data()};
+                double* out[] = {fs.data()};
+                bool* outFailed[] = {failed.get()};
+                kernel->run(args, out, outFailed, n);
+            }
+
+            for (size_t k = 0; k < n; ++k) {
+                if (!kernel || failed[k]) {
+                    if (!local) {
+                        local = std::make_unique<Evaluator>();
+                        local->setBackend(backend);
+                    }
+                    try {
+                        Value f = local->ApplyLambda(function, {Value(static_cast<Number>(xs[k])), Value(static_cast<Number>(ys[k]))}, *local);
+                        fs[k] = f.isNumber() ? static_cast<double>(f.asNumber()) : nan;
+                    } catch (...) {
+                        fs[k] = nan;
+                        if (!blockError)
+                            blockError = std::current_exception();
+                    }
+                }
+                values[nodes[k]] = std::isfinite(fs[k]) ? fs[k] : nan;
+                blockSampled = blockSampled || std::isfinite(fs[k]);
+            }
+        };
+
+        std::vector<Segment> segments;
+        // f = 0 рівно у вузлі дає відрізки нульової довжини з перетинів сусідніх ребер
+        auto add = [&](const PlotPoint& a, const PlotPoint& b) {
+            if (keyOf(a) != keyOf(b))
+                segments.push_back({a, b});
+        };
+        auto march = [&](const Cell& cell, const double* v) {
+            if (!std::isfinite(v[0]) || !std::isfinite(v[1]) || !std::isfinite(v[2]) || !std::isfinite(v[3]))
+                return;
+
+            // ребро завжди проходить зліва направо чи згори донизу, як і в сусідньої клітинки
+            const int i0 = cell.i, j0 = cell.j;
+            const int i1 = cell.i + cell.size, j1 = cell.j + cell.size;
+            auto crossing = [&](int pi, int pj, double vp, int qi, int qj, double vq) {
+                const double t = vp / (vp - vq);
+                const double px = xAt(pi);
+                const double py = yAt(pj);
+                return PlotPoint{px + (xAt(qi) - px) * t, py + (yAt(qj) - py) * t};
+            };
+
+            // кути за годинниковою стрілкою від лівого верхнього; ребра: верхнє, праве, нижнє, ліве
+            const bool inside[4] = {v[0] >= 0, v[1] >= 0, v[2] >= 0, v[3] >= 0};
+            const bool cut[4] = {inside[0] != inside[1], inside[1] != inside[2], inside[3] != inside[2], inside[0] != inside[3]};
+            PlotPoint edge[4];
+            if (cut[0])
+                edge[0] = crossing(i0, j0, v[0], i1, j0, v[1]);
+            if (cut[1])
+                edge[1] = crossing(i1, j0, v[1], i1, j1, v[2]);
+            if (cut[2])
+                edge[2] = crossing(i0, j1, v[3], i1, j1, v[2]);
+            if (cut[3])
+                edge[3] = crossing(i0, j0, v[0], i0, j1, v[3]);
+
+            const int count = cut[0] + cut[1] + cut[2] + cut[3];
+            if (count == 2) {
+                const PlotPoint* points[2];
+                int n = 0;
+                for (int e = 0; e < 4; ++e)
+                    if (cut[e])
+                        points[n++] = &edge[e];
+                add(*points[0], *points[1]);
+            } else if (count == 4) {
+                // сідло: знак у центрі вирішує, які з протилежних кутів з'єднані
+                const bool centre = (v[0] + v[1] + v[2] + v[3]) / 4 >= 0;
+                if (centre == inside[0]) {
+                    add(edge[0], edge[1]);
+                    add(edge[2], edge[3]);
+                } else {
+                    add(edge[0], edge[3]);
+                    add(edge[1], edge[2]);
+                }
+            }
+        };
+
+        std::vector<Cell> cells;
+        for (int j = 0; j < BlockCells; ++j)
+            for (int i = 0; i < BlockCells; ++i)
+                cells.push_back({i * Fine, j * Fine, Fine});
+
+        for (int depth = 0; !cells.empty(); ++depth) {
+            std::vector<int> nodes;
+            auto want = [&](int i, int j) {
+                const int node = j * side + i;
+                if (!known[node]) {
+                    known[node] = true;
+                    nodes.push_back(node);
+                }
+            };
+            for (const Cell& cell : cells) {
+                want(cell.i, cell.j);
+                want(cell.i + cell.size, cell.j);
+                want(cell.i + cell.size, cell.j + cell.size);
+                want(cell.i, cell.j + cell.size);
+            }
+            if (!nodes.empty())
+                evaluate(nodes);
+
+            std::vector<Cell> next;
+            for (const Cell& cell : cells) {
+                const double v[4] = {values[cell.j * side + cell.i],
+                                     values[cell.j * side + cell.i + cell.size],
+                                     values[(cell.j + cell.size) * side + cell.i + cell.size],
+                                     values[(cell.j + cell.size) * side + cell.i]};
+                if (depth == maxDepth) {
+                    march(cell, v);
+                } else if (nearZero(v)) {
+                    const int half = cell.size / 2;
+                    next.push_back({cell.i, cell.j, half});
+                    next.push_back({cell.i + half, cell.j, half});
+                    next.push_back({cell.i, cell.j + half, half});
+                    next.push_back({cell.i + half, cell.j + half, half});
+                }
+            }
+            cells = std::move(next);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        found[block] = std::move(segments);
+        sampled = sampled || blockSampled;
+        if (blockError && block < errorBlock) {
+            errorBlock = block;
+            error = blockError;
+        }
+    });
+
+    if (!sampled && error) {
+        if (!failure)
+            std::rethrow_exception(error);
+        *failure = error;
+    }
+
+    std::vector<Segment> segments;
+    for (const auto& block : found)
+        segments.insert(segments.end(), block.begin(), block.end());
+    return stitch(segments);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef IMPLICITSAMPLER_H
+#define IMPLICITSAMPLER_H
+
+#include "sampler.h"
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Лінія f(x, y) = 0 у видимій області методом marching squares. Область ділиться
+// на блоки, що обробляються паралельно на ThreadPool. У кожному блоці f
+// обчислюється на сітці клітинок у кілька пікселів, і лише клітинки поблизу
+// нуля f (знак змінюється чи |f| менше за перепад у клітинці) діляться на
+// чотири, до пів пікселя. Точки кожного рівня поділу блоку обчислюються одним
+// пакетом: числова лямбда - ядром Kernel на два аргументи, решта -
+// інтерпретатором, власним у кожному блоці.
+class ImplicitSampler
+{
+public:
+    ImplicitSampler(Evaluator& eval, std::shared_ptr<Lambda> function);
+
+    // Ламані лінії f = 0 у view; точка з y = NaN розділяє ламані. Без refine -
+    // лише початкова сітка. Точка з помилкою чи нечисловим значенням f
+    // вважається поза областю визначення. Помилка прокидається, лише якщо f не
+    // обчислилася в жодній точці; якщо передано failure, вона лише записується туди.
+    std::vector<PlotPoint> contour(const PlotView& view, bool refine = true, std::exception_ptr* failure = nullptr);
+
+    // як Sampler::setCancel; перевіряється перед кожним рівнем поділу блоку
+    void setCancel(std::function<bool()> cancelled);
+
+private:
+    Evaluator::Backend backend;
+    std::shared_ptr<Lambda> function;
+    std::unique_ptr<Kernel> kernel; // nullptr - f обчислює інтерпретатор
+    std::function<bool()> cancelled;
+};
+
+#endif // IMPLICITSAMPLER_H
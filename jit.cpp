@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "jit.h"
+#include <cstring>
+
+#ifdef GRAPHREPL_JIT
+#include <sys/mman.h>
+#endif
+
+void X86Emitter::prologue() {
+    code.insert(code.end(), {0x53, 0x48, 0x89, 0xFB});
+}
+
+void X86Emitter::epilogue() {
+    code.insert(code.end(), {0x5B, 0xC3});
+}
+
+void X86Emitter::memoryOp(uint8_t prefix, uint8_t opcode, int reg, int32_t offset) {
+    // modrm: [rbx + disp32]
+    code.insert(code.end(), {prefix, 0x0F, opcode, static_cast<uint8_t>(0x83 | (reg << 3))});
+    uint8_t disp[4];
+    std::memcpy(disp, &offset, sizeof(disp));
+    code.insert(code.end(), disp, disp + 4);
+}
+
+void X86Emitter::registerOp(uint8_t prefix, uint8_t opcode, int dst, int src) {
+    code.insert(code.end(), {prefix, 0x0F, opcode, static_cast<uint8_t>(0xC0 | (dst << 3) | src)});
+}
+
+void X86Emitter::load(int xmm, int32_t offset) {
+    memoryOp(0x66, 0x10, xmm, offset);
+}
+
+void X86Emitter::store(int32_t offset, int xmm) {
+    memoryOp(0x66, 0x11, xmm, offset);
+}
+
+void X86Emitter::loadLane(int xmm, int32_t offset) {
+    memoryOp(0xF2, 0x10, xmm, offset);
+}
+
+void X86Emitter::storeLane(int32_t offset, int xmm) {
+    memoryOp(0xF2, 0x11, xmm, offset);
+}
+
+void X86Emitter::move(int dst, int src) {
+    registerOp(0x66, 0x28, dst, src);
+}
+
+void X86Emitter::packed(PackedOp op, int dst, int src) {
+    registerOp(0x66, op, dst, src);
+}
+
+void X86Emitter::compare(int dst, int src, Predicate predicate) {
+    registerOp(0x66, 0xC2, dst, src);
+    code.push_back(predicate);
+}
+
+void X86Emitter::zero(int xmm) {
+    packed(Xor, xmm, xmm);
+}
+
+void X86Emitter::allOnes(int xmm) {
+    registerOp(0x66, 0x76, xmm, xmm);
+}
+
+void X86Emitter::call(const void* function) {
+    uint8_t address[8];
+    std::memcpy(address, &function, sizeof(address));
+    code.insert(code.end(), {0x48, 0xB8});
+    code.insert(code.end(), address, address + 8);
+    code.insert(code.end(), {0xFF, 0xD0});
+}
+
+const std::vector<uint8_t>& X86Emitter::bytes() const {
+    return code;
+}
+
+std::unique_ptr<ExecutableCode> ExecutableCode::create(const std::vector<uint8_t>& bytes) {
+#ifdef GRAPHREPL_JIT
+    void* memory = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    std::memcpy(memory, bytes.data(), bytes.size());
+    if (mprotect(memory, bytes.size(), PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, bytes.size());
+        return nullptr;
+    }
+    return std::unique_ptr<ExecutableCode>(new ExecutableCode(memory, bytes.size()));
+#else
+    (void)bytes;
+    return nullptr;
+#endif
+}
+
+ExecutableCode::ExecutableCode(void* memory, size_t size) : memory(memory), size(size) {}
+
+ExecutableCode::~ExecutableCode() {
+#ifdef GRAPHREPL_JIT
+    munmap(memory, size);
+#endif
+}
+
+ExecutableCode::Function ExecutableCode::function() const {
+    return reinterpret_cast<Function>(memory);
+}
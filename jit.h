@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// JIT є лише для x86-64 під Unix; деінде та з GRAPHREPL_NO_JIT ядра виконуються циклами
+#if defined(__x86_64__) && defined(__unix__) && !defined(GRAPHREPL_NO_JIT)
+#define GRAPHREPL_JIT
+#endif
+
+// Кодувальник потрібної Kernel підмножини SSE2. Усі дані лежать у кадрі, на який
+// вказує rbx; адреси задаються зміщенням від нього. Регістри - xmm0..xmm7.
+class X86Emitter
+{
+public:
+    enum PackedOp : uint8_t {
+        And = 0x54, AndNot = 0x55, Or = 0x56, Xor = 0x57,
+        Add = 0x58, Mul = 0x59, Sub = 0x5C, Div = 0x5E, Sqrt = 0x51
+    };
+    // предикати cmppd; "більше" виражається оберненими операндами
+    enum Predicate : uint8_t { Equal = 0, Less = 1, LessEqual = 2 };
+
+    void prologue();                                 // push rbx; mov rbx, rdi
+    void epilogue();                                 // pop rbx; ret
+    void load(int xmm, int32_t offset);              // movupd xmm, [rbx+offset]
+    void store(int32_t offset, int xmm);             // movupd [rbx+offset], xmm
+    void loadLane(int xmm, int32_t offset);          // movsd xmm, [rbx+offset]
+    void storeLane(int32_t offset, int xmm);         // movsd [rbx+offset], xmm
+    void move(int dst, int src);                     // movapd dst, src
+    void packed(PackedOp op, int dst, int src);      // dst = dst op src; andnpd: ~dst & src; sqrtpd: sqrt(src)
+    void compare(int dst, int src, Predicate predicate);
+    void zero(int xmm);                              // xorpd xmm, xmm
+    void allOnes(int xmm);                           // pcmpeqd xmm, xmm
+    void call(const void* function);                 // mov rax, imm64; call rax
+
+    const std::vector<uint8_t>& bytes() const;
+
+private:
+    void memoryOp(uint8_t prefix, uint8_t opcode, int reg, int32_t offset);
+    void registerOp(uint8_t prefix, uint8_t opcode, int dst, int src);
+
+    std::vector<uint8_t> code;
+};
+
+// Машинний код у власній сторінці пам'яті: запис, потім лише читання й виконання
+class ExecutableCode
+{
+public:
+    using Function = void (*)(double* frame);
+
+    // nullptr, якщо система не дала виконувану пам'ять
+    static std::unique_ptr<ExecutableCode> create(const std::vector<uint8_t>& bytes);
+    ~ExecutableCode();
+
+    Function function() const;
+
+private:
+    ExecutableCode(void* memory, size_t size);
+
+    void* memory;
+    size_t size;
+};
+
+#endif // JIT_H
@@ -0,0 +1,935 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "kernel.h"
+#include "environment.h"
+#include "lambda.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t BlockSize = 256;       // стільки x обчислюється за один прохід по коду
+const uint64_t AllOnes = ~uint64_t(0);
+
+// Регістр ядра для одного блоку x
+struct Column
+{
+    double num[BlockSize];
+    uint64_t mask[BlockSize];
+    uint64_t err[BlockSize];
+};
+
+// Арифметика: одна операція на обидва шляхи, щоб біти збігалися з інтерпретатором
+struct AddOp {
+    static double scalar(double a, double b) { return a + b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+};
+
+struct SubOp {
+    static double scalar(double a, double b) { return a - b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+#endif
+};
+
+struct MulOp {
+    static double scalar(double a, double b) { return a * b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#endif
+};
+
+struct DivOp {
+    static double scalar(double a, double b) { return a / b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+#endif
+};
+
+struct NegOp {
+    static double scalar(double a) { return -a; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+#endif
+};
+
+struct RecipOp {
+    static double scalar(double a) { return 1 / a; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a) { return _mm256_div_pd(_mm256_set1_pd(1.0), a); }
+#endif
+};
+
+struct SqrtOp {
+    static double scalar(double a) { return std::sqrt(a); }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a) { return _mm256_sqrt_pd(a); }
+#endif
+};
+
+// Порівняння впорядковані й тихі, як оператори C++: з NaN завжди false
+struct LessOp {
+    static bool scalar(double a, double b) { return a < b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+#endif
+};
+
+struct GreaterOp {
+    static bool scalar(double a, double b) { return a > b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+#endif
+};
+
+struct LessEqualOp {
+    static bool scalar(double a, double b) { return a <= b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+#endif
+};
+
+struct GreaterEqualOp {
+    static bool scalar(double a, double b) { return a >= b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+#endif
+};
+
+struct EqualOp {
+    static bool scalar(double a, double b) { return a == b; }
+#ifdef __AVX2__
+    static __m256d vec(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+#endif
+};
+
+template <typename F>
+void binary(double* out, const double* a, const double* b, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, F::vec(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+#endif
+    for (; i < n; ++i)
+        out[i] = F::scalar(a[i], b[i]);
+}
+
+template <typename F>
+void unary(double* out, const double* a, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, F::vec(_mm256_loadu_pd(a + i)));
+#endif
+    for (; i < n; ++i)
+        out[i] = F::scalar(a[i]);
+}
+
+// mask &= a op b
+template <typename F>
+void compare(uint64_t* mask, const double* a, const double* b, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256i m = _mm256_castpd_si256(F::vec(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), _mm256_and_si256(old, m));
+    }
+#endif
+    for (; i < n; ++i)
+        mask[i] &= F::scalar(a[i], b[i]) ? AllOnes : 0;
+}
+
+// err |= (a == 0): саме тут "/" інтерпретатора кидає "division by zero"
+void markZero(uint64_t* err, const double* a, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d zero = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256i m = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_loadu_pd(a + i), zero, _CMP_EQ_OQ));
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(err + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(err + i), _mm256_or_si256(old, m));
+    }
+#endif
+    for (; i < n; ++i)
+        err[i] |= a[i] == 0 ? AllOnes : 0;
+}
+
+// out = taken ? a : out
+void select(double* out, const uint64_t* taken, const double* a, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        __m256d m = _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(taken + i)));
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(_mm256_loadu_pd(out + i), _mm256_loadu_pd(a + i), m));
+    }
+#endif
+    for (; i < n; ++i)
+        if (taken[i])
+            out[i] = a[i];
+}
+
+// функції без векторного аналога в стандартній бібліотеці
+template <typename F>
+void perLane(double* out, const double* a, size_t n, F f) {
+    for (size_t i = 0; i < n; ++i)
+        out[i] = f(a[i]);
+}
+
+enum class Primitive { Plus, Minus, Mul, Div, Sqrt, Pow, Sin, Cos, Tan, Asin, Acos, Atan,
+                       Less, Greater, LessEqual, GreaterEqual, Equal, Not, And, Or };
+
+// Кадр машинного коду: службові слоти по 16 байт (2 числа), далі регістри ядра,
+// кожен - числа, маски й помилки для двох x
+const int32_t SignSlot = 0;
+const int32_t OneSlot = 16;
+const int32_t InputSlot = 32;     // по слоту на кожен аргумент
+const int32_t FirstRegister = InputSlot + 16 * Kernel::MaxArity;
+const int32_t RegisterSize = 48;
+
+int32_t inputOffset(int arg) { return InputSlot + arg * 16; }
+int32_t numOffset(int r) { return FirstRegister + r * RegisterSize; }
+int32_t maskOffset(int r) { return numOffset(r) + 16; }
+int32_t errOffset(int r) { return numOffset(r) + 32; }
+
+// функції бібліотеки, які машинний код викликає для кожного числа
+double callSin(double v) { return std::sin(v); }
+double callCos(double v) { return std::cos(v); }
+double callTan(double v) { return std::tan(v); }
+double callAsin(double v) { return std::asin(v); }
+double callAcos(double v) { return std::acos(v); }
+double callAtan(double v) { return std::atan(v); }
+double callPow(double a, double b) { return std::pow(a, b); }
+
+const std::unordered_map<Symbol, Primitive>& primitives() {
+    static const std::unordered_map<Symbol, Primitive> table = {
+        {SymbolTable::intern("+"), Primitive::Plus},
+        {SymbolTable::intern("-"), Primitive::Minus},
+        {SymbolTable::intern("*"), Primitive::Mul},
+        {SymbolTable::intern("/"), Primitive::Div},
+        {SymbolTable::intern("SQRT"), Primitive::Sqrt},
+        {SymbolTable::intern("POW"), Primitive::Pow},
+        {SymbolTable::intern("SIN"), Primitive::Sin},
+        {SymbolTable::intern("COS"), Primitive::Cos},
+        {SymbolTable::intern("TAN"), Primitive::Tan},
+        {SymbolTable::intern("ASIN"), Primitive::Asin},
+        {SymbolTable::intern("ACOS"), Primitive::Acos},
+        {SymbolTable::intern("ATAN"), Primitive::Atan},
+        {SymbolTable::intern("<"), Primitive::Less},
+        {SymbolTable::intern(">"), Primitive::Greater},
+        {SymbolTable::intern("<="), Primitive::LessEqual},
+        {SymbolTable::intern(">="), Primitive::GreaterEqual},
+        {SymbolTable::intern("="), Primitive::Equal},
+        {SymbolTable::intern("NOT"), Primitive::Not},
+        {Sym::AND, Primitive::And},
+        {Sym::OR, Primitive::Or},
+    };
+    return table;
+}
+
+}
+
+std::unique_ptr<Kernel> Kernel::compile(const std::vector<std::shared_ptr<Lambda>>& lambdas, size_t arity) {
+#ifdef GRAPHREPL_LONG_DOUBLE
+    (void)lambdas;
+    (void)arity;
+    return nullptr;
+#else
+    if (arity > MaxArity)
+        return nullptr;
+    std::unique_ptr<Kernel> kernel(new Kernel());
+    kernel->arity = arity;
+    bool any = false;
+
+    for (const auto& lambda : lambdas) {
+        // лямбді з більшою кількістю аргументів інтерпретатор кидає помилку,
+        // зайві аргументи він просто не використовує
+        const auto& forms = lambda->getBody();
+        int result = -1;
+        if (lambda->getArgs().size() <= arity && forms.size() == 1) {
+            const size_t mark = kernel->code.size();
+            try {
+                result = kernel->number(forms[0], *lambda);
+            } catch (const Unsupported&) {
+                kernel->rollback(mark);
+            }
+        }
+        kernel->results.push_back(result);
+        any = any || result >= 0;
+    }
+
+    if (!any)
+        return nullptr;
+    kernel->known.clear();
+#ifdef GRAPHREPL_JIT
+    kernel->compileNative();
+#endif
+    return kernel;
+#endif
+}
+
+bool Kernel::covers(size_t lambda) const {
+    return lambda < results.size() && results[lambda] >= 0;
+}
+
+int Kernel::append(Instruction instruction) {
+    if (instruction.op != Op::Const && instruction.op != Op::Arg)
+        for (int arg : instruction.args)
+            instruction.mayFail = instruction.mayFail || code[arg].mayFail;
+
+    // та сама операція над тими самими регістрами дає той самий стовпець,
+    // тож повторний підвираз (у цій чи іншій лямбді) бере вже наявний регістр
+    uint64_t bits;
+    std::memcpy(&bits, &instruction.number, sizeof(bits));
+    Key key{instruction.op, instruction.args, bits, instruction.boolean, instruction.isBool, instruction.hasElse};
+    auto found = known.find(key);
+    if (found != known.end())
+        return found->second;
+
+    code.push_back(std::move(instruction));
+    const int reg = static_cast<int>(code.size()) - 1;
+    known.emplace(std::move(key), reg);
+    return reg;
+}
+
+void Kernel::rollback(size_t size) {
+    // лямбда не підійшла: її інструкції прибираються, спільні з іншими лишаються
+    code.resize(size);
+    for (auto it = known.begin(); it != known.end();)
+        it = it->second >= static_cast<int>(size) ? known.erase(it) : std::next(it);
+}
+
+int Kernel::number(ListObject* exp, const Lambda& lambda) {
+    int reg = expression(exp, lambda);
+    if (code[reg].isBool)
+        throw Unsupported();
+    return reg;
+}
+
+int Kernel::constant(const Value& value) {
+    Instruction constant{Op::Const, {}};
+    if (value.isNumber()) {
+        constant.number = value.asNumber();
+    } else if (value.isBool()) {
+        constant.boolean = value.asBool();
+        constant.isBool = true;
+    } else {
+        throw Unsupported();
+    }
+    return append(std::move(constant));
+}
+
+int Kernel::expression(ListObject* exp, const Lambda& lambda) {
+    if (exp->isAtom()) {
+        switch (exp->atomType()) {
+        case ListObject::AtomType::Number:
+            return constant(Value(exp->asNumber()));
+        case ListObject::AtomType::Boolean:
+            return constant(Value(exp->asBoolean()));
+        case ListObject::AtomType::String:
+            throw Unsupported();
+        case ListObject::AtomType::Symbol:
+            // кадр виклику лямбди містить лише аргументи, усе інше - в її середовищі
+            if (exp->slot() >= 0 && exp->depth() == 0) {
+                if (static_cast<size_t>(exp->slot()) >= lambda.getArgs().size())
+                    throw Unsupported();
+                return append({Op::Arg, {}, static_cast<double>(exp->slot())});
+            }
+            if (exp->slot() >= 0) {
+                try {
+                    return constant(lambda.getEnv()->lookup(exp->depth() - 1, exp->slot()));
+                } catch (const std::runtime_error&) {
+                    throw Unsupported();
+                }
+            }
+            if (Value value; lambda.getEnv()->find(exp->asSymbol(), value))
+                return constant(value);
+            throw Unsupported();
+        }
+    }
+
+    if (isLambda(exp) || isBegin(exp))
+        throw Unsupported();
+    if (isCond(exp))
+        return cond(exp->asList(), lambda);
+
+    const auto& list = exp->asList();
+    if (list.empty() || !list[0]->isAtom() || list[0]->atomType() != ListObject::AtomType::Symbol)
+        throw Unsupported();
+    return primitive(list[0]->asSymbol(), list, lambda);
+}
+
+int Kernel::primitive(Symbol head, const ListObject::List& list, const Lambda& lambda) {
+    auto it = primitives().find(head);
+    if (it == primitives().end())
+        throw Unsupported();
+
+    const size_t argc = list.size() - 1;
+    auto numbers = [&] {
+        std::vector<int> args;
+        for (size_t i = 1; i < list.size(); ++i)
+            args.push_back(number(list[i], lambda));
+        return args;
+    };
+    // ліва згортка в тому ж порядку, що й у primitive.cpp
+    auto fold = [&](Op op, int acc, const std::vector<int>& args, size_t from) {
+        for (size_t i = from; i < args.size(); ++i)
+            acc = append({op, {acc, args[i]}});
+        return acc;
+    };
+    auto unaryOp = [&](Op op) {
+        if (argc != 1)
+            throw Unsupported();
+        return append({op, numbers()});
+    };
+    auto comparison = [&](Op op) {
+        Instruction compare{op, numbers()};
+        compare.isBool = true;
+        return append(std::move(compare));
+    };
+
+    switch (it->second) {
+    case Primitive::Plus: {
+        // 0 + a, а не просто a: інакше -0 лишився б -0
+        Instruction zero{Op::Const, {}};
+        return fold(Op::Add, append(std::move(zero)), numbers(), 0);
+    }
+    case Primitive::Minus: {
+        if (argc == 0)
+            throw Unsupported();
+        auto args = numbers();
+        return argc == 1 ? append({Op::Neg, args}) : fold(Op::Sub, args[0], args, 1);
+    }
+    case Primitive::Mul: {
+        auto args = numbers();
+        if (args.empty()) {
+            Instruction one{Op::Const, {}};
+            one.number = 1;
+            return append(std::move(one));
+        }
+        return fold(Op::Mul, args[0], args, 1);
+    }
+    case Primitive::Div: {
+        if (argc == 0)
+            throw Unsupported();
+        auto args = numbers();
+        if (argc == 1) {
+            Instruction recip{Op::Recip, args};
+            recip.mayFail = true;
+            return append(std::move(recip));
+        }
+        int acc = args[0];
+        for (size_t i = 1; i < args.size(); ++i) {
+            Instruction div{Op::Div, {acc, args[i]}};
+            div.mayFail = true;
+            acc = append(std::move(div));
+        }
+        return acc;
+    }
+    case Primitive::Sqrt: return unaryOp(Op::Sqrt);
+    case Primitive::Sin: return unaryOp(Op::Sin);
+    case Primitive::Cos: return unaryOp(Op::Cos);
+    case Primitive::Tan: return unaryOp(Op::Tan);
+    case Primitive::Asin: return unaryOp(Op::Asin);
+    case Primitive::Acos: return unaryOp(Op::Acos);
+    case Primitive::Atan: return unaryOp(Op::Atan);
+    case Primitive::Pow:
+        if (argc != 2)
+            throw Unsupported();
+        return append({Op::Pow, numbers()});
+    case Primitive::Less: return comparison(Op::Less);
+    case Primitive::Greater: return comparison(Op::Greater);
+    case Primitive::LessEqual: return comparison(Op::LessEqual);
+    case Primitive::GreaterEqual: return comparison(Op::GreaterEqual);
+    case Primitive::Equal:
+        if (argc != 2)
+            throw Unsupported();
+        return comparison(Op::Equal);
+    case Primitive::Not:
+    case Primitive::And:
+    case Primitive::Or: {
+        if (argc == 0 || (it->second == Primitive::Not && argc != 1))
+            throw Unsupported();
+        Instruction logic{it->second == Primitive::Not ? Op::Not : it->second == Primitive::And ? Op::And : Op::Or, {}};
+        for (size_t i = 1; i < list.size(); ++i)
+            logic.args.push_back(expression(list[i], lambda));
+        logic.isBool = true;
+        return append(std::move(logic));
+    }
+    }
+    throw Unsupported();
+}
+
+int Kernel::cond(const ListObject::List& list, const Lambda& lambda) {
+    if (list.size() < 2)
+        throw Unsupported();
+
+    Instruction select{Op::Cond, {}};
+    for (size_t i = 1; i < list.size(); ++i) {
+        const auto& clause = list[i];
+        if (clause->isAtom() || clause->asList().size() < 2)
+            throw Unsupported();
+
+        // як і в інтерпретаторі, гілка - лише другий елемент клаузи
+        const auto& inner = clause->asList();
+        if (inner[0]->isAtom() && inner[0]->asSymbol() == Sym::ELSE) {
+            select.args.push_back(number(inner[1], lambda));
+            select.hasElse = true;
+            break;
+        }
+        select.args.push_back(expression(inner[0], lambda));
+        select.args.push_back(number(inner[1], lambda));
+    }
+    return append(std::move(select));
+}
+
+void Kernel::run(const double* const* args, double* const* ys, bool* const* failed, size_t n) const {
+    if (native) {
+        runNative(args, ys, failed, n);
+        return;
+    }
+
+    std::vector<Column> regs(code.size());
+    std::vector<uint64_t> alive(BlockSize);
+    std::vector<uint64_t> hit(BlockSize);
+
+    for (size_t r = 0; r < code.size(); ++r) {
+        if (code[r].op != Op::Const)
+            continue;
+        std::fill_n(regs[r].num, BlockSize, code[r].number);
+        std::fill_n(regs[r].mask, BlockSize, code[r].boolean ? AllOnes : 0);
+    }
+
+    // логічна "хибність" і "істинність" значення: число не є ні тим, ні іншим
+    auto isFalse = [&](int r, size_t i) { return code[r].isBool ? ~regs[r].mask[i] : 0; };
+    auto isTrue = [&](int r, size_t i) { return code[r].isBool ? regs[r].mask[i] : 0; };
+    auto errorOf = [&](int r, size_t i) { return code[r].mayFail ? regs[r].err[i] : 0; };
+
+    for (size_t start = 0; start < n; start += BlockSize) {
+        const size_t m = std::min(BlockSize, n - start);
+
+        for (size_t r = 0; r < code.size(); ++r) {
+            const Instruction& ins = code[r];
+            Column& out = regs[r];
+            const double* a = ins.args.empty() ? nullptr : regs[ins.args[0]].num;
+            const double* b = ins.args.size() < 2 ? nullptr : regs[ins.args[1]].num;
+
+            // для простих операцій помилка - об'єднання помилок аргументів
+            if (ins.mayFail && ins.op != Op::Not && ins.op != Op::And && ins.op != Op::Or && ins.op != Op::Cond) {
+                std::fill_n(out.err, m, 0);
+                for (int arg : ins.args)
+                    if (code[arg].mayFail)
+                        for (size_t i = 0; i < m; ++i)
+                            out.err[i] |= regs[arg].err[i];
+            }
+
+            switch (ins.op) {
+            case Op::Const:
+                break;
+            case Op::Arg:
+                std::memcpy(out.num, args[static_cast<size_t>(ins.number)] + start, m * sizeof(double));
+                break;
+            case Op::Add: binary<AddOp>(out.num, a, b, m); break;
+            case Op::Sub: binary<SubOp>(out.num, a, b, m); break;
+            case Op::Mul: binary<MulOp>(out.num, a, b, m); break;
+            case Op::Div:
+                binary<DivOp>(out.num, a, b, m);
+                markZero(out.err, b, m);
+                break;
+            case Op::Neg: unary<NegOp>(out.num, a, m); break;
+            case Op::Recip:
+                unary<RecipOp>(out.num, a, m);
+                markZero(out.err, a, m);
+                break;
+            case Op::Sqrt: unary<SqrtOp>(out.num, a, m); break;
+            case Op::Pow:
+                for (size_t i = 0; i < m; ++i)
+                    out.num[i] = std::pow(a[i], b[i]);
+                break;
+            case Op::Sin: perLane(out.num, a, m, [](double v) { return std::sin(v); }); break;
+            case Op::Cos: perLane(out.num, a, m, [](double v) { return std::cos(v); }); break;
+            case Op::Tan: perLane(out.num, a, m, [](double v) { return std::tan(v); }); break;
+            case Op::Asin: perLane(out.num, a, m, [](double v) { return std::asin(v); }); break;
+            case Op::Acos: perLane(out.num, a, m, [](double v) { return std::acos(v); }); break;
+            case Op::Atan: perLane(out.num, a, m, [](double v) { return std::atan(v); }); break;
+            case Op::Less:
+            case Op::Greater:
+            case Op::LessEqual:
+            case Op::GreaterEqual:
+            case Op::Equal:
+                // ланцюжок (< a b c): кожна сусідня пара
+                std::fill_n(out.mask, m, AllOnes);
+                for (size_t k = 1; k < ins.args.size(); ++k) {
+                    const double* l = regs[ins.args[k - 1]].num;
+                    const double* r = regs[ins.args[k]].num;
+                    switch (ins.op) {
+                    case Op::Less: compare<LessOp>(out.mask, l, r, m); break;
+                    case Op::Greater: compare<GreaterOp>(out.mask, l, r, m); break;
+                    case Op::LessEqual: compare<LessEqualOp>(out.mask, l, r, m); break;
+                    case Op::GreaterEqual: compare<GreaterEqualOp>(out.mask, l, r, m); break;
+                    default: compare<EqualOp>(out.mask, l, r, m); break;
+                    }
+                }
+                break;
+            case Op::Not:
+                for (size_t i = 0; i < m; ++i) {
+                    out.mask[i] = isFalse(ins.args[0], i);
+                    out.err[i] = errorOf(ins.args[0], i);
+                }
+                break;
+            case Op::And:
+            case Op::Or: {
+                // аргументи обчислюються до першого FALSE (AND) чи TRUE (OR):
+                // помилка далі за ним не рахується
+                const bool isAnd = ins.op == Op::And;
+                std::fill_n(alive.begin(), m, AllOnes);
+                std::fill_n(out.mask, m, isAnd ? AllOnes : 0);
+                std::fill_n(out.err, m, 0);
+                for (int arg : ins.args) {
+                    for (size_t i = 0; i < m; ++i) {
+                        const uint64_t e = errorOf(arg, i);
+                        const uint64_t stop = alive[i] & ~e & (isAnd ? isFalse(arg, i) : isTrue(arg, i));
+                        out.err[i] |= alive[i] & e;
+                        out.mask[i] = isAnd ? out.mask[i] & ~stop : out.mask[i] | stop;
+                        alive[i] &= ~e & ~stop;
+                    }
+                }
+                break;
+            }
+            case Op::Cond: {
+                // жодна умова не справдилася - результат Value(), тобто 0
+                std::fill_n(alive.begin(), m, AllOnes);
+                std::fill_n(out.num, m, 0.0);
+                std::fill_n(out.err, m, 0);
+                const size_t clauses = ins.args.size() - (ins.hasElse ? 1 : 0);
+                for (size_t k = 0; k < clauses; k += 2) {
+                    const int test = ins.args[k];
+                    const int branch = ins.args[k + 1];
+                    for (size_t i = 0; i < m; ++i) {
+                        const uint64_t e = errorOf(test, i);
+                        hit[i] = alive[i] & ~e & ~isFalse(test, i);
+                        out.err[i] |= (alive[i] & e) | (hit[i] & errorOf(branch, i));
+                        alive[i] &= ~e & ~hit[i];
+                    }
+                    select(out.num, hit.data(), regs[branch].num, m);
+                }
+                if (ins.hasElse) {
+                    const int branch = ins.args.back();
+                    for (size_t i = 0; i < m; ++i)
+                        out.err[i] |= alive[i] & errorOf(branch, i);
+                    select(out.num, alive.data(), regs[branch].num, m);
+                }
+                break;
+            }
+            }
+        }
+
+        for (size_t k = 0; k < results.size(); ++k) {
+            const int result = results[k];
+            if (result < 0)
+                continue;
+            std::memcpy(ys[k] + start, regs[result].num, m * sizeof(double));
+            for (size_t i = 0; i < m; ++i)
+                failed[k][start + i] = errorOf(result, i) != 0;
+        }
+    }
+}
+
+void Kernel::compileNative() {
+    X86Emitter x86;
+    x86.prologue();
+
+    // значення регістра як логічне: число не є ні FALSE, ні TRUE
+    auto loadFalse = [&](int xmm, int r) {
+        if (!code[r].isBool) {
+            x86.zero(xmm);
+            return;
+        }
+        x86.load(xmm, maskOffset(r));
+        x86.allOnes(7);
+        x86.packed(X86Emitter::Xor, xmm, 7);
+    };
+    auto loadTrue = [&](int xmm, int r) {
+        if (code[r].isBool)
+            x86.load(xmm, maskOffset(r));
+        else
+            x86.zero(xmm);
+    };
+    auto loadError = [&](int xmm, int r) {
+        if (code[r].mayFail)
+            x86.load(xmm, errOffset(r));
+        else
+            x86.zero(xmm);
+    };
+    auto markZero = [&](int r, int divisor) {
+        x86.load(2, numOffset(divisor));
+        x86.zero(3);
+        x86.compare(2, 3, X86Emitter::Equal);
+        x86.load(0, errOffset(r));
+        x86.packed(X86Emitter::Or, 0, 2);
+        x86.store(errOffset(r), 0);
+    };
+    auto binaryOp = [&](X86Emitter::PackedOp op, int r, int a, int b) {
+        x86.load(0, numOffset(a));
+        x86.load(1, numOffset(b));
+        x86.packed(op, 0, 1);
+        x86.store(numOffset(r), 0);
+    };
+    auto perLane = [&](const void* function, int r, int a, int b) {
+        for (int32_t lane = 0; lane < 16; lane += 8) {
+            x86.loadLane(0, numOffset(a) + lane);
+            if (b >= 0)
+                x86.loadLane(1, numOffset(b) + lane);
+            x86.call(function);
+            x86.storeLane(numOffset(r) + lane, 0);
+        }
+    };
+
+    for (int r = 0; r < static_cast<int>(code.size()); ++r) {
+        const Instruction& ins = code[r];
+        const int a = ins.args.empty() ? -1 : ins.args[0];
+        const int b = ins.args.size() < 2 ? -1 : ins.args[1];
+
+        if (ins.mayFail && ins.op != Op::Not && ins.op != Op::And && ins.op != Op::Or && ins.op != Op::Cond) {
+            x86.zero(0);
+            for (int arg : ins.args) {
+                if (!code[arg].mayFail)
+                    continue;
+                x86.load(1, errOffset(arg));
+                x86.packed(X86Emitter::Or, 0, 1);
+            }
+            x86.store(errOffset(r), 0);
+        }
+
+        switch (ins.op) {
+        case Op::Const:
+            break;
+        case Op::Arg:
+            x86.load(0, inputOffset(static_cast<int>(ins.number)));
+            x86.store(numOffset(r), 0);
+            break;
+        case Op::Add: binaryOp(X86Emitter::Add, r, a, b); break;
+        case Op::Sub: binaryOp(X86Emitter::Sub, r, a, b); break;
+        case Op::Mul: binaryOp(X86Emitter::Mul, r, a, b); break;
+        case Op::Div:
+            binaryOp(X86Emitter::Div, r, a, b);
+            markZero(r, b);
+            break;
+        case Op::Neg:
+            x86.load(0, numOffset(a));
+            x86.load(1, SignSlot);
+            x86.packed(X86Emitter::Xor, 0, 1);
+            x86.store(numOffset(r), 0);
+            break;
+        case Op::Recip:
+            x86.load(0, OneSlot);
+            x86.load(1, numOffset(a));
+            x86.packed(X86Emitter::Div, 0, 1);
+            x86.store(numOffset(r), 0);
+            markZero(r, a);
+            break;
+        case Op::Sqrt:
+            x86.load(0, numOffset(a));
+            x86.packed(X86Emitter::Sqrt, 0, 0);
+            x86.store(numOffset(r), 0);
+            break;
+        case Op::Pow: perLane(reinterpret_cast<const void*>(&callPow), r, a, b); break;
+        case Op::Sin: perLane(reinterpret_cast<const void*>(&callSin), r, a, -1); break;
+        case Op::Cos: perLane(reinterpret_cast<const void*>(&callCos), r, a, -1); break;
+        case Op::Tan: perLane(reinterpret_cast<const void*>(&callTan), r, a, -1); break;
+        case Op::Asin: perLane(reinterpret_cast<const void*>(&callAsin), r, a, -1); break;
+        case Op::Acos: perLane(reinterpret_cast<const void*>(&callAcos), r, a, -1); break;
+        case Op::Atan: perLane(reinterpret_cast<const void*>(&callAtan), r, a, -1); break;
+        case Op::Less:
+        case Op::Greater:
+        case Op::LessEqual:
+        case Op::GreaterEqual:
+        case Op::Equal:
+            x86.allOnes(4);
+            for (size_t k = 1; k < ins.args.size(); ++k) {
+                // a > b - це b < a, a >= b - це b <= a
+                const bool swap = ins.op == Op::Greater || ins.op == Op::GreaterEqual;
+                x86.load(1, numOffset(ins.args[swap ? k : k - 1]));
+                x86.load(2, numOffset(ins.args[swap ? k - 1 : k]));
+                x86.compare(1, 2, ins.op == Op::Equal ? X86Emitter::Equal
+                                  : ins.op == Op::Less || ins.op == Op::Greater ? X86Emitter::Less
+                                  : X86Emitter::LessEqual);
+                x86.packed(X86Emitter::And, 4, 1);
+            }
+            x86.store(maskOffset(r), 4);
+            break;
+        case Op::Not:
+            loadFalse(0, a);
+            x86.store(maskOffset(r), 0);
+            loadError(0, a);
+            x86.store(errOffset(r), 0);
+            break;
+        case Op::And:
+        case Op::Or: {
+            // xmm5 - аргументи, які ще обчислюються, xmm6 - результат
+            const bool isAnd = ins.op == Op::And;
+            x86.allOnes(5);
+            if (isAnd)
+                x86.allOnes(6);
+            else
+                x86.zero(6);
+            x86.zero(0);
+            x86.store(errOffset(r), 0);
+            for (int arg : ins.args) {
+                loadError(1, arg);
+                if (isAnd)
+                    loadFalse(2, arg);
+                else
+                    loadTrue(2, arg);
+                // stop = alive & ~e & (false для AND, true для OR)
+                x86.move(3, 1);
+                x86.packed(X86Emitter::AndNot, 3, 2);
+                x86.packed(X86Emitter::And, 3, 5);
+                // err |= alive & e
+                x86.move(4, 1);
+                x86.packed(X86Emitter::And, 4, 5);
+                x86.load(0, errOffset(r));
+                x86.packed(X86Emitter::Or, 0, 4);
+                x86.store(errOffset(r), 0);
+                if (isAnd) {
+                    x86.move(4, 3);
+                    x86.packed(X86Emitter::AndNot, 4, 6);
+                    x86.move(6, 4);
+                } else {
+                    x86.packed(X86Emitter::Or, 6, 3);
+                }
+                // alive &= ~(e | stop)
+                x86.move(4, 1);
+                x86.packed(X86Emitter::Or, 4, 3);
+                x86.packed(X86Emitter::AndNot, 4, 5);
+                x86.move(5, 4);
+            }
+            x86.store(maskOffset(r), 6);
+            break;
+        }
+        case Op::Cond: {
+            // xmm5 - жодна умова ще не справдилася, xmm6 - результат (Value() = 0)
+            x86.allOnes(5);
+            x86.zero(6);
+            x86.zero(0);
+            x86.store(errOffset(r), 0);
+            const size_t clauses = ins.args.size() - (ins.hasElse ? 1 : 0);
+            for (size_t k = 0; k <= clauses; k += 2) {
+                const bool isElse = k == clauses;
+                if (isElse && !ins.hasElse)
+                    break;
+                const int branch = isElse ? ins.args.back() : ins.args[k + 1];
+
+                if (isElse) {
+                    x86.move(3, 5);
+                } else {
+                    // hit = alive & ~(e | false)
+                    loadError(1, ins.args[k]);
+                    loadFalse(2, ins.args[k]);
+                    x86.move(3, 1);
+                    x86.packed(X86Emitter::Or, 3, 2);
+                    x86.packed(X86Emitter::AndNot, 3, 5);
+                    // err |= alive & e
+                    x86.move(4, 1);
+                    x86.packed(X86Emitter::And, 4, 5);
+                    x86.load(0, errOffset(r));
+                    x86.packed(X86Emitter::Or, 0, 4);
+                    x86.store(errOffset(r), 0);
+                    // alive &= ~(e | hit)
+                    x86.move(4, 1);
+                    x86.packed(X86Emitter::Or, 4, 3);
+                    x86.packed(X86Emitter::AndNot, 4, 5);
+                    x86.move(5, 4);
+                }
+                // err |= hit & помилка гілки
+                if (code[branch].mayFail) {
+                    x86.load(4, errOffset(branch));
+                    x86.packed(X86Emitter::And, 4, 3);
+                    x86.load(0, errOffset(r));
+                    x86.packed(X86Emitter::Or, 0, 4);
+                    x86.store(errOffset(r), 0);
+                }
+                // result = (hit & branch) | (~hit & result)
+                x86.load(4, numOffset(branch));
+                x86.packed(X86Emitter::And, 4, 3);
+                x86.packed(X86Emitter::AndNot, 3, 6);
+                x86.packed(X86Emitter::Or, 3, 4);
+                x86.move(6, 3);
+            }
+            x86.store(numOffset(r), 6);
+            break;
+        }
+        }
+    }
+
+    x86.epilogue();
+    native = ExecutableCode::create(x86.bytes());
+}
+
+void Kernel::runNative(const double* const* args, double* const* ys, bool* const* failed, size_t n) const {
+    std::vector<double> frame((FirstRegister + RegisterSize * code.size()) / sizeof(double));
+    auto at = [&](int32_t offset) { return frame.data() + offset / sizeof(double); };
+
+    std::fill_n(at(SignSlot), 2, -0.0);
+    std::fill_n(at(OneSlot), 2, 1.0);
+    for (size_t r = 0; r < code.size(); ++r) {
+        if (code[r].op != Op::Const)
+            continue;
+        const uint64_t mask = code[r].boolean ? AllOnes : 0;
+        std::fill_n(at(numOffset(r)), 2, code[r].number);
+        std::memcpy(at(maskOffset(r)), &mask, sizeof(mask));
+        std::memcpy(at(maskOffset(r)) + 1, &mask, sizeof(mask));
+    }
+
+    const ExecutableCode::Function function = native->function();
+    for (size_t i = 0; i < n; i += 2) {
+        const size_t lanes = std::min<size_t>(2, n - i);
+        for (size_t arg = 0; arg < arity; ++arg) {
+            at(inputOffset(static_cast<int>(arg)))[0] = args[arg][i];
+            at(inputOffset(static_cast<int>(arg)))[1] = args[arg][i + lanes - 1];
+        }
+        function(frame.data());
+
+        for (size_t k = 0; k < results.size(); ++k) {
+            const int result = results[k];
+            if (result < 0)
+                continue;
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                ys[k][i + lane] = at(numOffset(result))[lane];
+                uint64_t err = 0;
+                if (code[result].mayFail)
+                    std::memcpy(&err, at(errOffset(result)) + lane, sizeof(err));
+                failed[k][i + lane] = err != 0;
+            }
+        }
+    }
+}
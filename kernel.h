@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "jit.h"
+#include "listobject.h"
+#include "value.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+class Lambda;
+
+// Числова лямбда одного чи двох аргументів, скомпільована для обчислення цілими
+// стовпцями. Підходять тіла з однієї форми, де є лише аргументи, числа, TRUE/FALSE, вільні змінні
+// з числовим значенням, + - * / SQRT POW SIN COS TAN ASIN ACOS ATAN, порівняння,
+// AND OR NOT та COND. Вільні змінні читаються під час компіляції, тож ядро
+// відповідає стану середовища на той момент.
+//
+// Усі гілки COND і всі аргументи AND/OR обчислюються для всіх x, а вибір робиться
+// масками, тому для кожного значення ядро ще й відстежує, чи кинув би тут помилку
+// інтерпретатор (ділення на нуль у гілці, до якої він би дійшов).
+// На x86-64 під Unix код ядра перекладається в машинні інструкції SSE2 (по 2 числа
+// за раз). Якщо це неможливо, ядро виконується стовпцями: арифметика й порівняння
+// по 4 числа через AVX2, якщо збірка його дозволяє (__AVX2__), інакше звичайними
+// циклами. SIN, POW тощо в обох випадках - std:: для кожного числа.
+//
+// Кілька лямбд компілюються в одне ядро з кількома результатами: однакові
+// підвирази, зокрема спільні для різних лямбд, обчислюються один раз.
+class Kernel
+{
+public:
+    static const size_t MaxArity = 2;
+
+    // Лямбди викликатимуться з arity аргументами; лямбда, що не підходить,
+    // пропускається (її обчислює інтерпретатор): covers(k) == false. nullptr,
+    // якщо не підходить жодна, а також у збірці з long double: ядро рахує в double
+    static std::unique_ptr<Kernel> compile(const std::vector<std::shared_ptr<Lambda>>& lambdas, size_t arity = 1);
+
+    bool covers(size_t lambda) const;
+
+    // ys[k][i] = k-та лямбда від args[0][i], ..., args[arity - 1][i] з точністю до
+    // біта, як в інтерпретатора, для кожної k, яку ядро покриває; failed[k][i] = true
+    // там, де інтерпретатор кинув би помилку (ys[k][i] тоді довільне)
+    void run(const double* const* args, double* const* ys, bool* const* failed, size_t n) const;
+
+private:
+    enum class Op {
+        Const, Arg,
+        Add, Sub, Mul, Div, Neg, Recip,
+        Sqrt, Pow, Sin, Cos, Tan, Asin, Acos, Atan,
+        Less, Greater, LessEqual, GreaterEqual, Equal,
+        Not, And, Or, Cond
+    };
+
+    // Інструкція пише в регістр з номером своєї позиції; регістр - стовпець чисел,
+    // стовпець масок (логічне значення) і стовпець помилок
+    struct Instruction
+    {
+        Op op;
+        std::vector<int> args;
+        double number = 0;     // Const; Arg - номер аргументу
+        bool boolean = false;  // Const логічного типу
+        bool isBool = false;   // тип результату
+        bool mayFail = false;  // чи може тут бути помилка
+        bool hasElse = false;  // Cond: остання гілка без умови
+    };
+
+    struct Unsupported {};
+
+    Kernel() = default;
+
+    int append(Instruction instruction);
+    void rollback(size_t size);
+    int expression(ListObject* exp, const Lambda& lambda);
+    int number(ListObject* exp, const Lambda& lambda);
+    int constant(const Value& value);
+    int primitive(Symbol head, const ListObject::List& list, const Lambda& lambda);
+    int cond(const ListObject::List& list, const Lambda& lambda);
+
+    void compileNative();
+    void runNative(const double* const* args, double* const* ys, bool* const* failed, size_t n) const;
+
+    using Key = std::tuple<Op, std::vector<int>, uint64_t, bool, bool, bool>;
+
+    size_t arity = 1;
+    std::vector<Instruction> code;
+    std::map<Key, int> known;      // інструкція -> її регістр, лише під час компіляції
+    std::vector<int> results;      // регістр результату кожної лямбди, -1 - не покрита
+    std::unique_ptr<ExecutableCode> native;
+};
+
+#endif // KERNEL_H
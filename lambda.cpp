@@ -1,35 +1,64 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "lambda.h"
-
-Lambda::Lambda(std::vector<std::string> args, std::shared_ptr<ListObject> body) {
-    this->args = args;
-    this->body = body;
-}
-
-std::vector<std::string> Lambda::getArgs() {
-    return this->args;
-}
-
-std::shared_ptr<ListObject> Lambda::getBody() {
-    return this->body;
-}
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "lambda.h"
+#include "bytecode.h"
+#include "environment.h"
+
+Lambda::Lambda(std::shared_ptr<LambdaPrototype> proto, std::shared_ptr<Environment> env) {
+    this->proto = proto;
+    this->env = env;
+}
+
+std::unique_ptr<LambdaPrototype> Lambda::makePrototype(ListObject* exp, const std::shared_ptr<AstArena>& arena) {
+    const auto& lambdaList = exp->asList();
+    auto proto = std::make_unique<LambdaPrototype>();
+    for (ListObject* param : lambdaList[1]->asList()) {
+        proto->args.push_back(param->asSymbol());
+    }
+
+    // тіло - форми після списку параметрів, у тому ж масиві арени
+    proto->body = lambdaList.from(2);
+    proto->frame = exp->frame() ? exp->frame() : std::make_shared<const std::vector<Symbol>>(proto->args);
+    proto->arena = arena;
+    return proto;
+}
+
+const std::vector<Symbol>& Lambda::getArgs() const {
+    return this->proto->args;
+}
+
+const ListObject::List& Lambda::getBody() const {
+    return this->proto->body;
+}
+
+const std::shared_ptr<const std::vector<Symbol>>& Lambda::getFrame() const {
+    return this->proto->frame;
+}
+
+const std::shared_ptr<Environment>& Lambda::getEnv() const {
+    return this->env;
+}
+
+std::shared_ptr<Lambda> Lambda::withEnv(std::shared_ptr<Environment> env) const {
+    return std::make_shared<Lambda>(proto, std::move(env));
+}
+
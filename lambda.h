@@ -1,38 +1,80 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef LAMBDA_H
-#define LAMBDA_H
-
-#include "listobject.h"
-
-class Lambda
-{
-public:
-    Lambda(std::vector<std::string> args, std::shared_ptr<ListObject> body);
-    std::vector<std::string> getArgs();
-    std::shared_ptr<ListObject> getBody();
-private:
-    std::vector<std::string> args;
-    std::shared_ptr<ListObject> body;
-};
-
-#endif // LAMBDA_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef LAMBDA_H
+#define LAMBDA_H
+
+#include "listobject.h"
+#include <mutex>
+
+struct Chunk;
+class Environment;
+
+// Незмінна частина лямбди, спільна для всіх замикань однієї форми LAMBDA.
+// Прототипом володіє вузол форми в арені, а замикання тримають shared_ptr на
+// прототип, що розділяє власність з ареною: доки живе замикання, живуть і
+// вузли тіла.
+struct LambdaPrototype
+{
+    std::vector<Symbol> args;
+    ListObject::List body;
+    // слоти кадру виклику: спершу параметри, далі локальні DEFINE
+    std::shared_ptr<const std::vector<Symbol>> frame;
+    // байткод тіла, компілюється VM при першому виклику
+    std::shared_ptr<const Chunk> code;
+    std::once_flag codeOnce;
+    // арена, в якій лежить форма; слабке посилання, бо арена володіє прототипом
+    std::weak_ptr<AstArena> arena;
+};
+
+// Замикання: прототип і середовище, в якому лямбду створено.
+// Кадр виклику є дочірнім саме до цього середовища (лексична область видимості).
+class Lambda
+{
+public:
+    Lambda(std::shared_ptr<LambdaPrototype> proto, std::shared_ptr<Environment> env);
+
+    // Прототип форми (LAMBDA (params) body...) з arena; Resolver створює його
+    // заздалегідь, щоб під час паралельного обчислення вузли AST лише читалися
+    static std::unique_ptr<LambdaPrototype> makePrototype(ListObject* exp, const std::shared_ptr<AstArena>& arena);
+    const std::vector<Symbol>& getArgs() const;
+    const ListObject::List& getBody() const;
+    const std::shared_ptr<const std::vector<Symbol>>& getFrame() const;
+    const std::shared_ptr<Environment>& getEnv() const;
+    // те саме замикання над іншим середовищем; без середовища (nullptr) воно
+    // зберігається у слоті кадру, де його створено (див. Environment::defineSlot)
+    std::shared_ptr<Lambda> withEnv(std::shared_ptr<Environment> env) const;
+    // байткод тіла; compile викликається один раз, навіть з кількох потоків.
+    // Результат тримає й арену, тож вузли, на які посилається байткод, живуть
+    template <typename Compile>
+    std::shared_ptr<const Chunk> getCode(Compile compile);
+private:
+    std::shared_ptr<LambdaPrototype> proto;
+    std::shared_ptr<Environment> env;
+};
+
+template <typename Compile>
+std::shared_ptr<const Chunk> Lambda::getCode(Compile compile) {
+    std::call_once(proto->codeOnce, [&] { proto->code = compile(); });
+    return std::shared_ptr<const Chunk>(proto, proto->code.get());
+}
+
+#endif // LAMBDA_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "lexer.h"
+#include <stdexcept>
+#include <string>
+
+static bool isDelimiter(char ch) {
+    return ch == '(' || ch == ')' || ch == ';'
+        || ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+Lexer::Lexer(std::string_view source) : src(source) {}
+
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+    tokens.reserve(src.size() / 4);
+
+    while (pos < src.size()) {
+        char ch = src[pos];
+
+        if (ch == ';') {
+            skipComment();
+        } else if (ch == '(' || ch == ')') {
+            tokens.push_back({src.substr(pos, 1), line, column});
+            advance();
+        } else if (ch == '"') {
+            tokens.push_back(lexString());
+        } else if (isDelimiter(ch)) {
+            advance();
+        } else {
+            tokens.push_back(lexAtom());
+        }
+    }
+
+    return tokens;
+}
+
+void Lexer::advance() {
+    if (src[pos] == '\n') {
+        ++line;
+        column = 1;
+    } else {
+        ++column;
+    }
+    ++pos;
+}
+
+void Lexer::skipComment() {
+    while (pos < src.size() && src[pos] != '\n')
+        advance();
+}
+
+Token Lexer::lexString() {
+    size_t start = pos;
+    Token token{{}, line, column};
+    advance(); // відкриваюча лапка
+
+    while (pos < src.size() && src[pos] != '"') {
+        if (src[pos] == '\\' && pos + 1 < src.size())
+            advance();
+        advance();
+    }
+
+    if (pos >= src.size())
+        throw std::runtime_error("Unterminated string starting at line " + std::to_string(token.line)
+                                 + ", column " + std::to_string(token.column));
+
+    advance(); // закриваюча лапка
+    token.text = src.substr(start, pos - start);
+    return token;
+}
+
+Token Lexer::lexAtom() {
+    size_t start = pos;
+    Token token{{}, line, column};
+
+    while (pos < src.size() && !isDelimiter(src[pos]))
+        advance();
+
+    token.text = src.substr(start, pos - start);
+    return token;
+}
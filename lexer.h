@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <string_view>
+#include <vector>
+
+struct Token
+{
+    std::string_view text;
+    size_t line;
+    size_t column;
+};
+
+// Однопрохідний лексер: токени посилаються на вихідний буфер,
+// тому він має жити довше за результат tokenize().
+class Lexer
+{
+public:
+    Lexer(std::string_view source);
+    std::vector<Token> tokenize();
+
+private:
+    void advance();
+    void skipComment();
+    Token lexString();
+    Token lexAtom();
+
+    std::string_view src;
+    size_t pos = 0;
+    size_t line = 1;
+    size_t column = 1;
+};
+
+#endif // LEXER_H
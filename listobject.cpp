@@ -1,80 +1,301 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "listobject.h"
-#include "tokenstream.h"
-#include <iostream>
-#include <algorithm>
-
-ListObject::ListObject(const std::string& atom) : value(atom) {}
-ListObject::ListObject(const List& list) : value(list) {}
-
-bool ListObject::isAtom() const {
-    return std::holds_alternative<std::string>(value);
-}
-
-std::string ListObject::asAtom() const {
-    return std::get<std::string>(value);
-}
-
-const ListObject::List& ListObject::asList() const {
-    return std::get<List>(value);
-}
-
-void ListObject::print(std::ostream& out , int indent) const {
-    if (isAtom()) {
-        out << asAtom();
-    } else {
-        out << "[";
-        const auto& list = asList();
-        for (size_t i = 0; i < list.size(); ++i) {
-            list[i]->print(out, indent + 1);
-            if (i < list.size() - 1) out << " ";
-        }
-        out << "]";
-    }
-}
-
-ListObject::Ptr ListObject::parse_tokens(TokenStream& ts) {
-    if (!ts.hasNext()) throw std::runtime_error("Unexpected end of input");
-
-    std::string token = ts.next();
-
-    if (token == "(") {
-        std::vector<ListObject::Ptr> list;
-        while (ts.hasNext() && ts.peek() != ")") {
-            list.push_back(parse_tokens(ts));
-        }
-        if (!ts.hasNext()) throw std::runtime_error("Missing closing ')'");
-        ts.next();
-        return std::make_shared<ListObject>(list);
-    } else if (token == ")") {
-        throw std::runtime_error("Unexpected ')'");
-    } else {
-        if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
-            return std::make_shared<ListObject>(token);
-        } else {
-            std::transform(token.begin(), token.end(), token.begin(), ::toupper);
-            return std::make_shared<ListObject>(token);
-        }
-    }
-}
-
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "listobject.h"
+#include "astarena.h"
+#include "lambda.h"
+#include "tokenstream.h"
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+std::string_view ListObject::asAtom() const {
+    switch (tag) {
+    case Tag::Symbol:
+        return SymbolTable::name(symbol);
+    case Tag::Boolean:
+        return boolean ? "TRUE" : "FALSE";
+    case Tag::Number:
+    case Tag::String:
+        return *text;
+    case Tag::List:
+        break;
+    }
+    return std::string_view();
+}
+
+ListObject::Form& ListObject::form() const {
+    // таблиця форм заповнюється під час розбору для кожного списку з головою LAMBDA чи BEGIN
+    if (tag != Tag::List || !formData)
+        throw std::logic_error("Node is not a LAMBDA or BEGIN form");
+    return *formData;
+}
+
+void ListObject::setAddress(int depth, int slot) {
+    frameDepth = depth;
+    frameSlot = slot;
+}
+
+void ListObject::setFrame(std::shared_ptr<const std::vector<Symbol>> names) {
+    form().frame = std::move(names);
+}
+
+const std::shared_ptr<const std::vector<Symbol>>& ListObject::frame() const {
+    static const std::shared_ptr<const std::vector<Symbol>> none;
+    return tag == Tag::List && formData ? formData->frame : none;
+}
+
+void ListObject::setCapturesLocals(bool captures) {
+    form().capturesLocals = captures;
+}
+
+bool ListObject::capturesLocals() const {
+    return tag == Tag::List && formData && formData->capturesLocals;
+}
+
+void ListObject::setPrototype(std::unique_ptr<LambdaPrototype> proto) {
+    form().prototype = std::move(proto);
+}
+
+LambdaPrototype* ListObject::prototype() const {
+    return tag == Tag::List && formData ? formData->prototype.get() : nullptr;
+}
+
+void ListObject::setNumber(Number value, const std::string* text) {
+    tag = Tag::Number;
+    number = value;
+    this->text = text;
+    symbol = Sym::None;
+    setAddress(-1, -1);
+}
+
+void ListObject::setBoolean(bool value) {
+    tag = Tag::Boolean;
+    boolean = value;
+    text = nullptr;
+    symbol = Sym::None;
+    setAddress(-1, -1);
+}
+
+void ListObject::assign(const ListObject& other) {
+    std::memcpy(static_cast<void*>(this), &other, sizeof(ListObject));
+    // зсув до дочірніх вузлів відраховується від самого вузла
+    if (tag == Tag::List)
+        children.offset += static_cast<std::int32_t>(&other - this);
+}
+
+void ListObject::removeChild(size_t index) {
+    ListObject* items = this + children.offset;
+    for (size_t i = index; i + 1 < children.count; ++i)
+        items[i].assign(items[i + 1]);
+    --children.count;
+}
+
+void ListObject::print(std::ostream& out , int indent) const {
+    if (isAtom()) {
+        if (tag == Tag::String)
+            out << "\"" << asAtom() << "\"";
+        else
+            out << asAtom();
+    } else {
+        out << "[";
+        const auto list = asList();
+        for (size_t i = 0; i < list.size(); ++i) {
+            list[i]->print(out, indent + 1);
+            if (i < list.size() - 1) out << " ";
+        }
+        out << "]";
+    }
+}
+
+ListObject::Ptr ListObject::parse_tokens(TokenStream& ts, AstArena& arena) {
+    // спершу вираз розбирається в прямому порядку, щоб знати розміри списків
+    std::vector<Parsed> parsed;
+    parse(ts, parsed);
+
+    // Далі вузли розкладаються в один масив: дочірні вузли кожного списку
+    // займають суцільну групу, а групи йдуть у порядку обходу вглиб, тож
+    // піддерево лямбди лежить компактно. pending - списки, розміщені в масиві,
+    // чиї дочірні вузли ще не розкладено: (індекс у масиві, індекс у parsed).
+    ListObject* nodes = arena.nodes(parsed.size());
+    if (parsed[0].token) {
+        parse_atom(parsed[0].token->text, arena, nodes);
+        return nodes;
+    }
+
+    std::vector<std::pair<size_t, size_t>> pending{{0, 0}};
+    size_t next = 1;
+    while (!pending.empty()) {
+        auto [at, source] = pending.back();
+        pending.pop_back();
+
+        const size_t count = parsed[source].count;
+        const size_t first = next;
+        next += count;
+
+        size_t child = source + 1;
+        for (size_t i = 0; i < count; ++i) {
+            if (parsed[child].token)
+                parse_atom(parsed[child].token->text, arena, nodes + first + i);
+            child += parsed[child].size;
+        }
+        // списки обробляються з кінця стеку: першим - перший дочірній
+        child = source + 1;
+        const size_t mark = pending.size();
+        for (size_t i = 0; i < count; ++i) {
+            if (!parsed[child].token)
+                pending.emplace_back(first + i, child);
+            child += parsed[child].size;
+        }
+        std::reverse(pending.begin() + mark, pending.end());
+
+        ListObject* node = new (nodes + at) ListObject();
+        node->tag = Tag::List;
+        node->symbol = Sym::None;
+        node->frameDepth = -1;
+        node->frameSlot = -1;
+        node->boolean = false;
+        node->children.offset = static_cast<std::int32_t>(first - at);
+        node->children.count = static_cast<std::uint32_t>(count);
+        node->formData = nullptr;
+        if (count > 0 && nodes[first].tag == Tag::Symbol
+            && (nodes[first].symbol == Sym::LAMBDA || nodes[first].symbol == Sym::BEGIN))
+            node->formData = arena.form();
+    }
+
+    return nodes;
+}
+
+void ListObject::parse(TokenStream& ts, std::vector<Parsed>& parsed) {
+    if (!ts.hasNext()) throw std::runtime_error("Unexpected end of input");
+
+    const Token& open = ts.next();
+
+    if (open.text == "(") {
+        const size_t at = parsed.size();
+        parsed.push_back({nullptr, 0, 1});
+        size_t count = 0;
+        while (ts.hasNext() && ts.peek().text != ")") {
+            parse(ts, parsed);
+            ++count;
+        }
+        if (!ts.hasNext())
+            throw std::runtime_error("Missing closing ')' for '(' at line " + std::to_string(open.line)
+                                     + ", column " + std::to_string(open.column));
+        ts.next();
+        parsed[at].count = count;
+        parsed[at].size = parsed.size() - at;
+    } else if (open.text == ")") {
+        throw std::runtime_error("Unexpected ')' at line " + std::to_string(open.line)
+                                 + ", column " + std::to_string(open.column));
+    } else {
+        parsed.push_back({&open, 0, 1});
+    }
+}
+
+// Дозволяє: -12, 3.14, -0.001, 42
+static bool isNumberLiteral(std::string_view token) {
+    size_t i = 0;
+    if (i < token.size() && token[i] == '-')
+        ++i;
+
+    size_t intStart = i;
+    while (i < token.size() && std::isdigit((unsigned char)token[i]))
+        ++i;
+    if (i == intStart)
+        return false;
+
+    if (i < token.size() && token[i] == '.') {
+        size_t fracStart = ++i;
+        while (i < token.size() && std::isdigit((unsigned char)token[i]))
+            ++i;
+        if (i == fracStart)
+            return false;
+    }
+
+    return i == token.size();
+}
+
+static Number parseNumber(const std::string& text) {
+#ifdef GRAPHREPL_LONG_DOUBLE
+    return std::strtold(text.c_str(), nullptr);
+#else
+    return std::strtod(text.c_str(), nullptr);
+#endif
+}
+
+static std::string decodeString(std::string_view token) {
+    std::string result;
+    result.reserve(token.size() - 2);
+
+    for (size_t i = 1; i + 1 < token.size(); ++i) {
+        char ch = token[i];
+        if (ch == '\\' && i + 2 < token.size()) {
+            ch = token[++i];
+            switch (ch) {
+            case 'n': ch = '\n'; break;
+            case 't': ch = '\t'; break;
+            default: break; // \" та \\ дають сам символ
+            }
+        }
+        result.push_back(ch);
+    }
+
+    return result;
+}
+
+void ListObject::parse_atom(std::string_view token, AstArena& arena, ListObject* node) {
+    node = new (node) ListObject();
+    node->symbol = Sym::None;
+    node->frameDepth = -1;
+    node->frameSlot = -1;
+    node->boolean = false;
+    node->number = 0;
+    node->text = nullptr;
+
+    if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
+        node->tag = Tag::String;
+        node->text = arena.text(decodeString(token));
+        return;
+    }
+
+    std::string text(token);
+    if (isNumberLiteral(token)) {
+        node->tag = Tag::Number;
+        node->number = parseNumber(text);
+        node->text = arena.text(text);
+        return;
+    }
+
+    std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+    if (text == "TRUE" || text == "FALSE") {
+        node->tag = Tag::Boolean;
+        node->boolean = text == "TRUE";
+        return;
+    }
+
+    // текст символу зберігає SymbolTable
+    node->tag = Tag::Symbol;
+    node->symbol = SymbolTable::intern(text);
+}
@@ -1,48 +1,222 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef LISPVALUE_H
-#define LISPVALUE_H
-
-#include "tokenstream.h"
-#include <iostream>
-#include <vector>
-#include <string>
-#include <variant>
-#include <memory>
-
-class ListObject
-{
-public:
-    using Ptr = std::shared_ptr<ListObject>;
-    using List = std::vector<Ptr>;
-    ListObject(const std::string& atom);
-    ListObject(const List& list);
-    bool isAtom() const;
-    std::string asAtom() const;
-    const List& asList() const;
-    void print(std::ostream& out = std::cout, int indent = 0) const;
-    static Ptr parse_tokens(TokenStream& ts);
-private:
-    std::variant<std::string, List> value;
-};
-
-#endif // LISPVALUE_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef LISPVALUE_H
+#define LISPVALUE_H
+
+#include "tokenstream.h"
+#include "symboltable.h"
+#include "number.h"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+
+struct LambdaPrototype;
+class AstArena;
+
+// Вузол AST - запис сталого розміру (32 байти, у режимі GRAPHREPL_LONG_DOUBLE -
+// 48, бо long double займає 16 байт і вирівнюється по 16): тег, число чи ID
+// символу, адреса змінної та зсув першого дочірнього вузла з їх кількістю.
+// Усі вузли одного виразу лежать одним масивом в AstArena, а дочірні вузли
+// списку - поспіль, одразу групою, тож обхід дерева йде пам'яттю послідовно. Тексти
+// рядків і чисел та дані форм LAMBDA і BEGIN зберігаються в таблицях арени.
+// Вузол живе, доки живе його арена.
+class ListObject
+{
+public:
+    using Ptr = ListObject*;
+
+    // Кадр і прототип форми LAMBDA чи BEGIN; лежить у таблиці арени
+    struct Form
+    {
+        std::shared_ptr<const std::vector<Symbol>> frame;
+        std::unique_ptr<LambdaPrototype> prototype;
+        bool capturesLocals = false;
+    };
+
+    // Дочірні вузли списку: відрізок масиву вузлів, без власності
+    class List
+    {
+    public:
+        // ітератор віддає покажчики на вузли, як і operator[]
+        class iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = ListObject*;
+            using difference_type = std::ptrdiff_t;
+            using pointer = ListObject* const*;
+            using reference = ListObject*;
+
+            explicit iterator(ListObject* node = nullptr);
+            ListObject* operator*() const;
+            iterator& operator++();
+            iterator operator++(int);
+            iterator operator+(difference_type n) const;
+            difference_type operator-(const iterator& other) const;
+            bool operator==(const iterator& other) const;
+            bool operator!=(const iterator& other) const;
+
+        private:
+            ListObject* node;
+        };
+
+        List() = default;
+        List(ListObject* items, size_t count);
+
+        iterator begin() const;
+        iterator end() const;
+        size_t size() const;
+        bool empty() const;
+        ListObject* operator[](size_t i) const;
+        ListObject* back() const;
+        // вузли, починаючи з first
+        List from(size_t first) const;
+
+    private:
+        ListObject* items = nullptr;
+        size_t count = 0;
+    };
+
+    // Тип атома визначається один раз під час розбору
+    enum class AtomType : std::uint8_t { Symbol, Number, Boolean, String };
+
+    ~ListObject() = default;
+    ListObject(const ListObject&) = delete;
+    ListObject& operator=(const ListObject&) = delete;
+
+    bool isAtom() const;
+    AtomType atomType() const;
+    std::string_view asAtom() const;
+    Symbol asSymbol() const;
+    Number asNumber() const;
+    bool asBoolean() const;
+    List asList() const;
+
+    // Лексична адреса змінної (глибина кадру, слот); -1 якщо не визначена
+    void setAddress(int depth, int slot);
+    int depth() const;
+    int slot() const;
+
+    // Імена слотів кадру, який створює форма LAMBDA або BEGIN
+    void setFrame(std::shared_ptr<const std::vector<Symbol>> names);
+    const std::shared_ptr<const std::vector<Symbol>>& frame() const;
+
+    // Чи звертається LAMBDA до локальних змінних охоплюючих форм;
+    // якщо ні, замикання тримає лише глобальне середовище
+    void setCapturesLocals(bool captures);
+    bool capturesLocals() const;
+
+    // Прототип лямбди, створює Resolver; належить формі LAMBDA
+    void setPrototype(std::unique_ptr<LambdaPrototype> proto);
+    LambdaPrototype* prototype() const;
+
+    // Перезапис вузла на місці для ConstantFolder, до Resolver: вузол стає
+    // літералом, копією іншого вузла того ж масиву чи списком без дочірнього вузла
+    void setNumber(Number value, const std::string* text);
+    void setBoolean(bool value);
+    void assign(const ListObject& other);
+    void removeChild(size_t index);
+
+    void print(std::ostream& out = std::cout, int indent = 0) const;
+    // Розбирає один вираз у новий масив вузлів arena; повертає корінь
+    static Ptr parse_tokens(TokenStream& ts, AstArena& arena);
+private:
+    // вузол у прямому порядку обходу, до розкладання в масив
+    struct Parsed
+    {
+        const Token* token; // атом; nullptr - список
+        size_t count;       // дочірніх вузлів списку
+        size_t size;        // вузлів у піддереві разом із цим
+    };
+
+    enum class Tag : std::uint8_t { Symbol, Number, Boolean, String, List };
+
+    ListObject() = default;
+    static void parse(TokenStream& ts, std::vector<Parsed>& parsed);
+    static void parse_atom(std::string_view token, AstArena& arena, ListObject* node);
+
+    Form& form() const;
+
+    union {
+        Number number;                  // Number
+        struct {
+            std::int32_t offset;        // від цього вузла до першого дочірнього
+            std::uint32_t count;
+        } children;                     // List
+    };
+    union {
+        const std::string* text;        // текст String та Number у таблиці арени
+        Form* formData;                 // LAMBDA та BEGIN; для інших списків nullptr
+    };
+    Symbol symbol;
+    std::int32_t frameDepth;
+    std::int32_t frameSlot;
+    Tag tag;
+    bool boolean;
+};
+
+#ifndef GRAPHREPL_LONG_DOUBLE
+static_assert(sizeof(ListObject) == 32, "AST node must stay 32 bytes");
+#else
+// де long double збігається з double (MSVC), вузол лишається 32-байтовим
+static_assert(sizeof(ListObject) == (sizeof(Number) == sizeof(double) ? 32 : 48),
+              "AST node must stay 48 bytes with long double");
+#endif
+
+inline ListObject::List::iterator::iterator(ListObject* node) : node(node) {}
+inline ListObject* ListObject::List::iterator::operator*() const { return node; }
+inline ListObject::List::iterator& ListObject::List::iterator::operator++() { ++node; return *this; }
+inline ListObject::List::iterator ListObject::List::iterator::operator++(int) { return iterator(node++); }
+inline ListObject::List::iterator ListObject::List::iterator::operator+(difference_type n) const { return iterator(node + n); }
+inline std::ptrdiff_t ListObject::List::iterator::operator-(const iterator& other) const { return node - other.node; }
+inline bool ListObject::List::iterator::operator==(const iterator& other) const { return node == other.node; }
+inline bool ListObject::List::iterator::operator!=(const iterator& other) const { return node != other.node; }
+
+inline ListObject::List::List(ListObject* items, size_t count) : items(items), count(count) {}
+
+inline ListObject::List::iterator ListObject::List::begin() const { return iterator(items); }
+inline ListObject::List::iterator ListObject::List::end() const { return iterator(items + count); }
+inline size_t ListObject::List::size() const { return count; }
+inline bool ListObject::List::empty() const { return count == 0; }
+inline ListObject* ListObject::List::operator[](size_t i) const { return items + i; }
+inline ListObject* ListObject::List::back() const { return items + count - 1; }
+inline ListObject::List ListObject::List::from(size_t first) const { return List(items + first, count - first); }
+
+inline bool ListObject::isAtom() const { return tag != Tag::List; }
+inline ListObject::AtomType ListObject::atomType() const { return static_cast<AtomType>(tag); }
+inline Symbol ListObject::asSymbol() const { return symbol; }
+inline Number ListObject::asNumber() const { return number; }
+inline bool ListObject::asBoolean() const { return boolean; }
+inline ListObject::List ListObject::asList() const {
+    if (tag != Tag::List)
+        return List();
+    return List(const_cast<ListObject*>(this) + children.offset, children.count);
+}
+inline int ListObject::depth() const { return frameDepth; }
+inline int ListObject::slot() const { return frameSlot; }
+
+#endif // LISPVALUE_H
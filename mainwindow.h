@@ -1,55 +1,58 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef MAINWINDOW_H
-#define MAINWINDOW_H
-
-#include "evaluator.h"
-#include "codeeditor.h"
-
-#include <QMainWindow>
-#include <QTextEdit>
-#include <QLabel>
-#include <QTableView>
-#include <QStandardItemModel>
-
-class Environment;
-class MainWindow : public QMainWindow
-{
-    Q_OBJECT
-    friend Environment;
-public:
-    MainWindow(QWidget *parent = nullptr);
-    ~MainWindow();
-
-private slots:
-    void evalButtonClick();
-    void updateTable();
-
-private:
-    CodeEditor *input;
-    QTextEdit *topRightWidget;
-    QTableView *table;
-    QStandardItemModel *model;
-    std::shared_ptr<Environment> env0;
-    Evaluator interp;
-};
-#endif // MAINWINDOW_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include "evaluator.h"
+#include "codeeditor.h"
+
+#include <QMainWindow>
+#include <QTextEdit>
+#include <QLabel>
+#include <QTableView>
+#include <QStandardItemModel>
+#include <memory>
+
+class Environment;
+class PlotManager;
+class MainWindow : public QMainWindow
+{
+    Q_OBJECT
+    friend Environment;
+public:
+    MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
+
+private slots:
+    void evalButtonClick();
+    void updateTable();
+
+private:
+    CodeEditor *input;
+    QTextEdit *topRightWidget;
+    QTableView *table;
+    QStandardItemModel *model;
+    std::shared_ptr<Environment> env0;
+    Evaluator interp;
+    std::unique_ptr<PlotManager> plots;
+};
+#endif // MAINWINDOW_H
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef NUMBER_H
+#define NUMBER_H
+
+// Тип чисел інтерпретатора обирається під час збірки.
+// За замовчуванням double: арифметика та sin/cos/pow йдуть через SSE,
+// а Value зберігає число прямо у своїх 8 байтах.
+// GRAPHREPL_LONG_DOUBLE вмикає точніший long double (x87, 80 біт);
+// тоді числа в Value зберігаються в купі, як рядки.
+#ifdef GRAPHREPL_LONG_DOUBLE
+using Number = long double;
+#else
+using Number = double;
+#endif
+
+#endif // NUMBER_H
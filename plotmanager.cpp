@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "plotmanager.h"
+#include <algorithm>
+
+PlotManager::PlotManager(QWidget *owner) : owner(owner) {}
+
+void PlotManager::show(Evaluator& eval, PlotSpec spec, std::vector<QColor> colors, int width, int height) {
+    windows.erase(std::remove_if(windows.begin(), windows.end(), [](const QPointer<PlotViewer>& window) { return window.isNull(); }),
+                  windows.end());
+
+    // окреме вікно, але дочірнє до owner: не тримає програму після закриття REPL
+    PlotViewer *window = new PlotViewer(eval, std::move(spec), std::move(colors), width, height, owner);
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->setWindowTitle("Plot Window");
+
+    if (windows.size() >= MaxWindows) {
+        // найстаріше вікно видаляється вже в циклі подій, після того як REPL
+        // відпустить середовище, на яке може чекати його фоновий потік
+        PlotViewer *oldest = windows.front();
+        windows.pop_front();
+        window->move(oldest->pos());
+        oldest->close();
+    }
+    windows.push_back(window);
+
+    window->show();
+    window->raise();
+    window->activateWindow();
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef PLOTMANAGER_H
+#define PLOTMANAGER_H
+
+#include "plotviewer.h"
+#include <QPointer>
+#include <deque>
+
+// Вікна графіків REPL. draw-plot, draw-plots, draw-parametric і draw-implicit
+// лише відкривають вікно PlotViewer з уже обчисленим грубим графіком і одразу
+// повертаються до REPL. Вікон не більше
+// MaxWindows: новий графік понад це займає місце найстарішого вікна. Закрите
+// вікно видаляється разом із кешем точок, а всі вікна належать owner і
+// зникають разом з ним.
+class PlotManager
+{
+public:
+    static const size_t MaxWindows = 8;
+
+    explicit PlotManager(QWidget *owner);
+
+    void show(Evaluator& eval, PlotSpec spec, std::vector<QColor> colors, int width, int height);
+
+private:
+    QWidget *owner;
+    std::deque<QPointer<PlotViewer>> windows; // від найстарішого; закриті стають nullptr
+};
+
+#endif // PLOTMANAGER_H
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "plotrenderer.h"
+#include "implicitsampler.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <cmath>
+#include <list>
+#include <mutex>
+
+namespace {
+
+const double Scale = 10.0;   // пікселів на одиницю
+const int GridStep = 10;
+
+// лінії сітки проходять через початок координат і рухаються разом з осями
+std::vector<double> gridLines(double origin, int size) {
+    std::vector<double> lines;
+    for (double p = origin - std::floor(origin / GridStep) * GridStep; p < size; p += GridStep)
+        lines.push_back(p);
+    return lines;
+}
+
+// Біле тло з сіткою на GridStep більше за полотно в кожен бік: зсунуте на фазу
+// початку координат, воно покриває все полотно, тож при панорамуванні шар не
+// перемальовується. Крок сітки в пікселях не залежить від масштабу, тому ключ -
+// лише розмір. Кешуються останні кілька розмірів (вікна й draw-plot-to-file).
+QImage gridLayer(int width, int height) {
+    struct Layer { int width; int height; QImage image; };
+    static std::mutex mutex;
+    static std::list<Layer> layers;
+    const size_t MaxLayers = 4;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = layers.begin(); it != layers.end(); ++it) {
+        if (it->width == width && it->height == height) {
+            layers.splice(layers.begin(), layers, it);
+            return it->image;
+        }
+    }
+
+    QImage image(width + GridStep, height + GridStep, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(Qt::gray, 1, Qt::DotLine));
+    for (int x = 0; x < width + GridStep; x += GridStep)
+        painter.drawLine(QLineF(x, 0, x, height + GridStep - 1));
+    for (int y = 0; y < height + GridStep; y += GridStep)
+        painter.drawLine(QLineF(0, y, width + GridStep - 1, y));
+    painter.end();
+
+    layers.push_front(Layer{width, height, image});
+    if (layers.size() > MaxLayers)
+        layers.pop_back();
+    return image;
+}
+
+// зсув шару сітки, за якого його лінії проходять через початок координат
+int gridOffset(double origin) {
+    return static_cast<int>(std::lround(origin - std::floor(origin / GridStep) * GridStep)) - GridStep;
+}
+
+}
+
+PlotRenderer::PlotRenderer(int width, int height) {
+    const long centerX = width / 2;
+    const long centerY = height / 2;
+    view = PlotView{-centerX / Scale, (width - centerX) / Scale,
+                    -(height - centerY) / Scale, centerY / Scale,
+                    width, height};
+}
+
+QColor PlotRenderer::defaultColor(size_t index) {
+    static const Qt::GlobalColor palette[] = {Qt::blue, Qt::red, Qt::darkGreen, Qt::magenta, Qt::darkYellow, Qt::cyan};
+    return palette[index % (sizeof(palette) / sizeof(palette[0]))];
+}
+
+void PlotRenderer::sample(Evaluator& eval, const PlotSpec& spec, std::vector<QColor> colors) {
+    // функції обчислюються паралельно, малюються все одно по порядку
+    switch (spec.kind) {
+    case PlotSpec::Kind::Explicit:
+        curves = Sampler(eval, spec.functions).adaptive(view);
+        break;
+    case PlotSpec::Kind::Parametric:
+        curves = {Sampler(eval, spec.functions).parametric(view, spec.tMin, spec.tMax)};
+        break;
+    case PlotSpec::Kind::Implicit:
+        curves = {ImplicitSampler(eval, spec.functions.at(0)).contour(view)};
+        break;
+    }
+    this->colors = std::move(colors);
+}
+
+std::vector<QPolygonF> PlotRenderer::polylines(const PlotView& view, const std::vector<PlotPoint>& points) {
+    std::vector<QPolygonF> lines;
+    const double top = -1;
+    const double bottom = view.height + 1;
+    bool joined = false;   // чи продовжує наступний відрізок останню ламану
+
+    for (size_t i = 1; i < points.size(); ++i) {
+        const PlotPoint& a = points[i - 1];
+        const PlotPoint& b = points[i];
+        if (!std::isfinite(a.y) || !std::isfinite(b.y)) {
+            joined = false;
+            continue;
+        }
+
+        double x0 = view.toPixelX(a.x), y0 = view.toPixelY(a.y);
+        double x1 = view.toPixelX(b.x), y1 = view.toPixelY(b.y);
+        if ((y0 < top && y1 < top) || (y0 > bottom && y1 > bottom)) {
+            joined = false;
+            continue;
+        }
+
+        // відрізок обрізається по краю, щоб лінія до полюса не йшла в нескінченність
+        auto clip = [&](double& x, double& y, double otherX, double otherY) {
+            double limit = std::max(top, std::min(bottom, y));
+            if (limit != y) {
+                x += (otherX - x) * (limit - y) / (otherY - y);
+                y = limit;
+                return true;
+            }
+            return false;
+        };
+        const bool clippedStart = clip(x0, y0, x1, y1);
+        const bool clippedEnd = clip(x1, y1, x0, y0);
+
+        if (!joined || clippedStart) {
+            lines.emplace_back();
+            lines.back().append(QPointF(x0, y0));
+        }
+        lines.back().append(QPointF(x1, y1));
+        joined = !clippedEnd;
+    }
+    return lines;
+}
+
+void PlotRenderer::paint(QPainter& painter, const PlotView& view, const PlotCurves& curves, const std::vector<QColor>& colors) {
+    const int wid = view.width;
+    const int heg = view.height;
+    const double originX = view.toPixelX(0);
+    const double originY = view.toPixelY(0);
+
+    // тло з сіткою береться з кешу, осі рухаються з кожним кадром і малюються поверх
+    painter.drawImage(gridOffset(originX), gridOffset(originY), gridLayer(wid, heg));
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(Qt::black, 2));
+    painter.drawLine(QLineF(0, originY, wid - 1, originY));
+    painter.drawLine(QLineF(originX, 0, originX, heg - 1));
+
+    for (size_t k = 0; k < curves.size(); ++k) {
+        painter.setPen(QPen(colors[k], 1));
+        for (const QPolygonF& line : polylines(view, curves[k]))
+            painter.drawPolyline(line);
+    }
+}
+
+QImage PlotRenderer::image() const {
+    QImage image(view.width, view.height, QImage::Format_RGB32);
+
+    QPainter painter(&image);
+    paint(painter, view, curves, colors);
+    painter.end();
+    return image;
+}
+
+QByteArray PlotRenderer::svg() const {
+    // те саме, що й paint, але текстом: SVG не потребує модуля QtSvg
+    const int wid = view.width;
+    const int heg = view.height;
+    const double originX = view.toPixelX(0);
+    const double originY = view.toPixelY(0);
+
+    QByteArray out;
+    auto number = [](double value) { return QByteArray::number(value, 'g', 10); };
+    auto line = [&](double x0, double y0, double x1, double y1) {
+        out += "<line x1=\"" + number(x0) + "\" y1=\"" + number(y0)
+             + "\" x2=\"" + number(x1) + "\" y2=\"" + number(y1) + "\"/>\n";
+    };
+
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out += "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" + number(wid) + "\" height=\"" + number(heg)
+         + "\" viewBox=\"0 0 " + number(wid) + " " + number(heg) + "\">\n";
+    out += "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+    out += "<g stroke=\"gray\" stroke-width=\"1\" stroke-dasharray=\"1,2\">\n";
+    for (double x : gridLines(originX, wid))
+        line(x, 0, x, heg - 1);
+    for (double y : gridLines(originY, heg))
+        line(0, y, wid - 1, y);
+    out += "</g>\n";
+
+    out += "<g stroke=\"black\" stroke-width=\"2\">\n";
+    line(0, originY, wid - 1, originY);
+    line(originX, 0, originX, heg - 1);
+    out += "</g>\n";
+
+    for (size_t k = 0; k < curves.size(); ++k) {
+        out += "<g stroke=\"" + colors[k].name().toUtf8() + "\" stroke-width=\"1\" fill=\"none\">\n";
+        for (const QPolygonF& polyline : polylines(view, curves[k])) {
+            QByteArray points;
+            for (const QPointF& point : polyline)
+                points += (points.isEmpty() ? "" : " ") + number(point.x()) + "," + number(point.y());
+            out += "<polyline points=\"" + points + "\"/>\n";
+        }
+        out += "</g>\n";
+    }
+    out += "</svg>\n";
+    return out;
+}
+
+bool PlotRenderer::save(const QString& path) const {
+    if (view.width <= 0 || view.height <= 0)
+        return false;
+
+    if (QFileInfo(path).suffix().compare("svg", Qt::CaseInsensitive) == 0) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        const QByteArray data = svg();
+        return file.write(data) == data.size();
+    }
+    return image().save(path);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef PLOTRENDERER_H
+#define PLOTRENDERER_H
+
+#include "evaluator.h"
+#include "sampler.h"
+#include <QByteArray>
+#include <QColor>
+#include <QImage>
+#include <QPolygonF>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QPainter;
+
+// Графік на полотні w×h пікселів з початком координат у центрі та 10 пікселями
+// на одиницю: кілька функцій y = f(x), параметрична чи неявна крива, спільна
+// сітка й осі, кожна крива своїм кольором. Вибірка точок і малювання в QImage
+// чи SVG без вікон і циклу подій.
+class PlotRenderer
+{
+public:
+    PlotRenderer(int width, int height);
+
+    // колір k-ї кривої, коли його не задано: першою йде синя, як у draw-plot
+    static QColor defaultColor(size_t index);
+
+    // функції y = f(x) вибираються разом, за один прохід по x; colors[k] - колір k-ї кривої
+    void sample(Evaluator& eval, const PlotSpec& spec, std::vector<QColor> colors);
+
+    QImage image() const;
+    QByteArray svg() const;
+
+    // формат за розширенням: .svg - SVG, інше (.png, .jpg, ...) - через QImage
+    bool save(const QString& path) const;
+
+    // Сітка, осі та криві у view; цим же малює вікно PlotViewer
+    static void paint(QPainter& painter, const PlotView& view, const PlotCurves& curves, const std::vector<QColor>& colors);
+
+    // Ламані кривої в пікселях view, обрізані по верхньому й нижньому краю;
+    // нова ламана починається лише там, де крива розривається чи виходить за край
+    static std::vector<QPolygonF> polylines(const PlotView& view, const std::vector<PlotPoint>& points);
+
+private:
+    PlotView view;
+    PlotCurves curves;
+    std::vector<QColor> colors;
+};
+
+#endif // PLOTRENDERER_H
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "plottiles.h"
+#include "environment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+
+namespace {
+
+const double BaseScale = 10.0;        // пікселів на одиницю на рівні 0, як у draw-plot
+const double BandPx = 65536.0;        // вище й нижче цієї смуги плитка y = f(x) не уточнюється
+const int FallbackLevels = 12;        // на скільки рівнів шукати заміну відсутній плитці
+const long long MaxFallbackTiles = 64;
+
+// фонові потоки, що ще працюють
+std::mutex workersMutex;
+std::condition_variable workersDone;
+int runningWorkers = 0;
+
+}
+
+bool TileKey::operator<(const TileKey& other) const {
+    return std::tie(level, index, row) < std::tie(other.level, other.index, other.row);
+}
+
+double PlotTiles::scale(int level) {
+    return BaseScale * std::pow(2.0, static_cast<double>(level) / LevelsPerOctave);
+}
+
+PlotTiles::PlotTiles(Evaluator& eval, PlotSpec spec, std::function<void()> ready)
+    : spec(std::move(spec)),
+      sampler(eval, this->spec.kind == PlotSpec::Kind::Implicit ? std::vector<std::shared_ptr<Lambda>>() : this->spec.functions),
+      ready(std::move(ready)) {
+    if (this->spec.kind == PlotSpec::Kind::Implicit)
+        implicit = std::make_unique<ImplicitSampler>(eval, this->spec.functions.at(0));
+
+    // prime виконується в REPL, що вже тримає замок, тож переривається лише фонова вибірка
+    auto cancelled = [this] { return stopping || Environment::writerWaiting(); };
+    sampler.setCancel(cancelled);
+    if (implicit)
+        implicit->setCancel(cancelled);
+}
+
+std::shared_ptr<PlotTiles> PlotTiles::create(Evaluator& eval, PlotSpec spec, std::function<void()> ready) {
+    auto tiles = std::make_shared<PlotTiles>(eval, std::move(spec), std::move(ready));
+    {
+        std::lock_guard<std::mutex> lock(workersMutex);
+        ++runningWorkers;
+    }
+
+    // останнім PlotTiles звільняє фоновий потік, якщо вікно вже закрито
+    std::thread([tiles]() mutable {
+        tiles->workerLoop();
+        tiles.reset();
+        std::lock_guard<std::mutex> lock(workersMutex);
+        if (--runningWorkers == 0)
+            workersDone.notify_all();
+    }).detach();
+    return tiles;
+}
+
+void PlotTiles::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+}
+
+void PlotTiles::joinStopped() {
+    std::unique_lock<std::mutex> lock(workersMutex);
+    workersDone.wait(lock, [] { return runningWorkers == 0; });
+}
+
+bool PlotTiles::planar() const {
+    return spec.kind != PlotSpec::Kind::Explicit;
+}
+
+PlotView PlotTiles::tileView(const TileKey& key) const {
+    const double s = scale(key.level);
+    if (planar())
+        return PlotView{key.index * TilePx / s, (key.index + 1) * TilePx / s,
+                        key.row * TilePx / s, (key.row + 1) * TilePx / s,
+                        TilePx, TilePx};
+
+    // плитка y = f(x) не залежить від зсуву по y: допуск уточнення рахується в
+    // пікселях масштабу плитки, а відсікання лише далеко за межами будь-якого вікна
+    return PlotView{key.index * TilePx / s, (key.index + 1) * TilePx / s,
+                    -BandPx / s, BandPx / s,
+                    TilePx, static_cast<int>(2 * BandPx)};
+}
+
+long long PlotTiles::tileIndex(int level, double coordinate) {
+    const double index = std::floor(coordinate * scale(level) / TilePx);
+    return static_cast<long long>(std::max(-1e15, std::min(1e15, index)));
+}
+
+PlotTiles::TileRange PlotTiles::range(int level, const PlotView& view) const {
+    if (!planar())
+        return TileRange{tileIndex(level, view.xMin), tileIndex(level, view.xMax), 0, 0};
+    return TileRange{tileIndex(level, view.xMin), tileIndex(level, view.xMax),
+                     tileIndex(level, view.yMin), tileIndex(level, view.yMax)};
+}
+
+PlotCurves PlotTiles::compute(const TileKey& key, bool refine, PlotCurves grid, std::vector<std::exception_ptr>& failures) {
+    const PlotView view = tileView(key);
+    failures.assign(spec.curveCount(), nullptr);
+
+    // уточнення y = f(x) продовжує грубу сітку, параметрична й неявна крива
+    // обчислюються наново: їхня груба сітка дешева порівняно з уточненням
+    switch (spec.kind) {
+    case PlotSpec::Kind::Explicit:
+        return refine ? sampler.refine(view, std::move(grid)) : sampler.grid(view, &failures);
+    case PlotSpec::Kind::Parametric:
+        return {sampler.parametric(view, spec.tMin, spec.tMax, refine, &failures[0])};
+    case PlotSpec::Kind::Implicit:
+        return {implicit->contour(view, refine, &failures[0])};
+    }
+    return {};
+}
+
+void PlotTiles::prime(int level, const PlotView& view) {
+    // функція, що не обчислилася в жодній плитці, - помилка всього графіка
+    std::vector<std::exception_ptr> errors(spec.curveCount());
+    std::vector<bool> sampled(spec.curveCount(), false);
+
+    const TileRange r = range(level, view);
+    for (long long row = r.firstRow; row <= r.lastRow; ++row) {
+        for (long long i = r.firstIndex; i <= r.lastIndex; ++i) {
+            const TileKey key{level, i, row};
+            std::vector<std::exception_ptr> failures;
+            PlotCurves grid = compute(key, false, {}, failures);
+            for (size_t k = 0; k < failures.size(); ++k) {
+                if (!failures[k])
+                    sampled[k] = true;
+                else if (!errors[k])
+                    errors[k] = failures[k];
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            tiles[key] = Tile{std::move(grid), false};
+        }
+    }
+
+    for (size_t k = 0; k < errors.size(); ++k)
+        if (!sampled[k] && errors[k])
+            std::rethrow_exception(errors[k]);
+    request(level, view);
+}
+
+void PlotTiles::request(int level, const PlotView& view) {
+    TileRange r = range(level, view);
+    r.firstIndex -= 1;
+    r.lastIndex += 1;
+    if (planar()) {
+        r.firstRow -= 1;
+        r.lastRow += 1;
+    }
+    const long long middle = r.firstIndex + (r.lastIndex - r.firstIndex) / 2;
+    const long long middleRow = r.firstRow + (r.lastRow - r.firstRow) / 2;
+
+    std::vector<TileKey> keys;
+    for (long long row = r.firstRow; row <= r.lastRow; ++row)
+        for (long long i = r.firstIndex; i <= r.lastIndex; ++i)
+            keys.push_back({level, i, row});
+    // від центру до країв
+    auto distance = [&](const TileKey& k) {
+        return (k.index - middle) * (k.index - middle) + (k.row - middleRow) * (k.row - middleRow);
+    };
+    std::stable_sort(keys.begin(), keys.end(), [&](const TileKey& a, const TileKey& b) { return distance(a) < distance(b); });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wanted = std::move(keys);
+        centre = {level, middle, middleRow};
+    }
+    wake.notify_one();
+}
+
+PlotCurves PlotTiles::curves(int level, const PlotView& view) const {
+    PlotCurves out(spec.curveCount());
+    std::set<TileKey> used;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const TileRange r = range(level, view);
+    for (long long row = r.firstRow; row <= r.lastRow; ++row) {
+        for (long long i = r.firstIndex; i <= r.lastIndex; ++i) {
+            const TileKey key{level, i, row};
+            auto it = tiles.find(key);
+            if (it != tiles.end()) {
+                append(it->second.curves, nullptr, out);
+                continue;
+            }
+
+            const PlotView area = tileView(key);
+            for (int d = 1; d <= FallbackLevels; ++d)
+                if (appendLevel(level - d, area, out, used) || appendLevel(level + d, area, out, used))
+                    break;
+        }
+    }
+
+    if (!planar())
+        for (auto& points : out)
+            std::sort(points.begin(), points.end(), [](const PlotPoint& l, const PlotPoint& r) { return l.x < r.x; });
+    return out;
+}
+
+void PlotTiles::append(const PlotCurves& curves, const PlotView* area, PlotCurves& out) const {
+    for (size_t k = 0; k < out.size(); ++k) {
+        if (planar()) {
+            // ламані різних плиток не з'єднуються між собою
+            if (!out[k].empty() && !curves[k].empty())
+                out[k].push_back({std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()});
+            out[k].insert(out[k].end(), curves[k].begin(), curves[k].end());
+        } else {
+            // точки y = f(x) потім сортуються, тож з чужої плитки беруться лише ті, що в area
+            for (const PlotPoint& p : curves[k])
+                if (!area || (p.x >= area->xMin && p.x <= area->xMax))
+                    out[k].push_back(p);
+        }
+    }
+}
+
+bool PlotTiles::appendLevel(int level, const PlotView& area, PlotCurves& out, std::set<TileKey>& used) const {
+    const TileRange r = range(level, area);
+    if ((r.lastIndex - r.firstIndex + 1) * (r.lastRow - r.firstRow + 1) > MaxFallbackTiles)
+        return false;
+
+    for (long long row = r.firstRow; row <= r.lastRow; ++row)
+        for (long long i = r.firstIndex; i <= r.lastIndex; ++i)
+            if (!tiles.count({level, i, row}))
+                return false;
+
+    // крупніша плитка може заміняти кілька відсутніх, але малюється один раз
+    for (long long row = r.firstRow; row <= r.lastRow; ++row) {
+        for (long long i = r.firstIndex; i <= r.lastIndex; ++i) {
+            const TileKey key{level, i, row};
+            if (planar() && !used.insert(key).second)
+                continue;
+            append(tiles.at(key).curves, &area, out);
+        }
+    }
+    return true;
+}
+
+bool PlotTiles::nextJob(TileKey& key, bool& refine) const {
+    // спершу грубі сітки всієї видимої області, потім уточнення
+    for (const TileKey& k : wanted) {
+        if (!tiles.count(k)) {
+            key = k;
+            refine = false;
+            return true;
+        }
+    }
+    for (const TileKey& k : wanted) {
+        if (!tiles.at(k).refined) {
+            key = k;
+            refine = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PlotTiles::evict() {
+    // запитані плитки вміщуються завжди: інакше великий вид неявної чи
+    // параметричної кривої викидав би плитки, які фоновий потік знову обчислює
+    const size_t limit = std::max(MaxTiles, wanted.size() + MaxTiles / 4);
+    if (tiles.size() <= limit)
+        return;
+
+    // викидаються плитки найдальших від видимої області рівнів, а в межах
+    // рівня - найдальші від її центру
+    const std::set<TileKey> requested(wanted.begin(), wanted.end());
+    const double centreX = (centre.index + 0.5) * TilePx / scale(centre.level);
+    const double centreY = (centre.row + 0.5) * TilePx / scale(centre.level);
+    std::vector<std::pair<double, TileKey>> scored;
+    for (const auto& [key, tile] : tiles) {
+        if (requested.count(key))
+            continue;
+        const double width = TilePx / scale(key.level);
+        const double dx = (key.index + 0.5) * width - centreX;
+        const double dy = planar() ? (key.row + 0.5) * width - centreY : 0;
+        scored.emplace_back(std::abs(key.level - centre.level) * 1e6 + std::hypot(dx, dy) / width, key);
+    }
+
+    const size_t target = limit * 3 / 4;
+    const size_t kept = tiles.size() - scored.size();
+    const size_t keep = target > kept ? target - kept : 0;
+    if (keep >= scored.size())
+        return;
+    std::nth_element(scored.begin(), scored.begin() + keep, scored.end(),
+                     [](const auto& l, const auto& r) { return l.first < r.first; });
+    for (size_t i = keep; i < scored.size(); ++i)
+        tiles.erase(scored[i].second);
+}
+
+void PlotTiles::workerLoop() {
+    for (;;) {
+        TileKey key;
+        bool refine;
+        PlotCurves grid;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || nextJob(key, refine); });
+            if (stopping)
+                return;
+            if (refine && !planar())
+                grid = tiles.at(key).curves;
+        }
+
+        // REPL чекає на замок: поступаємося йому, доки він не змінить середовище
+        while (Environment::writerWaiting() && !stopping)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // функція, що не обчислюється на всій плитці, лишає на ній лише NaN
+        Tile tile;
+        try {
+            std::shared_lock<std::shared_mutex> env(Environment::globalLock());
+            std::vector<std::exception_ptr> failures;
+            tile = Tile{compute(key, refine, std::move(grid), failures), refine};
+        } catch (const SamplingCancelled&) {
+            // плитка лишається в wanted і обчислиться наново
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping)
+            return;
+        tiles[key] = std::move(tile);
+        evict();
+        ready();
+    }
+}
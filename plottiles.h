@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef PLOTTILES_H
+#define PLOTTILES_H
+
+#include "implicitsampler.h"
+#include "sampler.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// Плитка кешу: TilePx×TilePx пікселів на рівні масштабу level. У графіків
+// y = f(x) плитка - уся смуга по y, тож row завжди 0
+struct TileKey
+{
+    int level;
+    long long index;
+    long long row = 0;
+
+    bool operator<(const TileKey& other) const;
+};
+
+// Кеш вибірки функцій для вікна з панорамуванням і масштабом. Площину кожного
+// рівня масштабу поділено на плитки: для y = f(x) - смуги по x, що не залежать
+// від зсуву по y, для параметричних і неявних кривих - квадрати. Тож
+// перетягування вікна та повернення до попереднього масштабу не обчислюють
+// функцію повторно. Відсутні видимі плитки обчислює фоновий потік: спершу
+// грубі сітки всіх плиток, далі уточнення кожної. Функція обчислюється під
+// спільним Environment::globalLock, щоб REPL не змінював середовище під час
+// обчислення; коли REPL чекає на замок, плитка переривається між шматками
+// точок і обчислюється пізніше. Фоновий потік сам тримає PlotTiles, тож вікно
+// при закритті лише зупиняє його (stop) і не чекає на обчислення.
+class PlotTiles
+{
+public:
+    static const int TilePx = 256;
+    static const int LevelsPerOctave = 4;     // крок колеса миші: масштаб x 2^(1/4)
+    static constexpr size_t MaxTiles = 1024;  // більше лише тоді, коли стільки запитано
+
+    // пікселів на одиницю; рівень 0 - масштаб draw-plot
+    static double scale(int level);
+
+    // ready викликається з фонового потоку після кожної нової плитки, але не після stop.
+    // Створювати через create: той запускає фоновий потік
+    PlotTiles(Evaluator& eval, PlotSpec spec, std::function<void()> ready);
+    static std::shared_ptr<PlotTiles> create(Evaluator& eval, PlotSpec spec, std::function<void()> ready);
+
+    // Фоновий потік покидає поточну плитку на найближчій перевірці й завершується
+    void stop();
+
+    // Чекає на фонові потоки зупинених PlotTiles; main викликає перед виходом,
+    // бо вони ще можуть користуватися ThreadPool
+    static void joinStopped();
+
+    // Синхронно обчислює грубі плитки view і прокидає помилку, якщо функція не
+    // обчислилася в жодній із них. Викликається з REPL (draw-plot), який уже
+    // тримає Environment::globalLock.
+    void prime(int level, const PlotView& view);
+
+    // Видима область змінилася: її відсутні плитки (і по одній з боків)
+    // обчислюються у фоні від центру до країв, застарілі запити скасовуються
+    void request(int level, const PlotView& view);
+
+    // Криві для малювання view на рівні level. Ще не обчислену плитку
+    // заміняють точки найближчого рівня, де ця ділянка вже є.
+    PlotCurves curves(int level, const PlotView& view) const;
+
+private:
+    struct Tile
+    {
+        PlotCurves curves;
+        bool refined;
+    };
+
+    // плитки рівня, що покривають область: стовпці й рядки включно
+    struct TileRange
+    {
+        long long firstIndex;
+        long long lastIndex;
+        long long firstRow;
+        long long lastRow;
+    };
+
+    static long long tileIndex(int level, double coordinate);
+
+    bool planar() const;
+    PlotView tileView(const TileKey& key) const;
+    TileRange range(int level, const PlotView& view) const;
+
+    PlotCurves compute(const TileKey& key, bool refine, PlotCurves grid, std::vector<std::exception_ptr>& failures);
+    void append(const PlotCurves& curves, const PlotView* area, PlotCurves& out) const;
+    bool appendLevel(int level, const PlotView& area, PlotCurves& out, std::set<TileKey>& used) const;
+    bool nextJob(TileKey& key, bool& refine) const;
+    void evict();
+    void workerLoop();
+
+    PlotSpec spec;
+    Sampler sampler;                            // y = f(x) і параметричні криві
+    std::unique_ptr<ImplicitSampler> implicit;  // лише для неявних
+    std::function<void()> ready;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::map<TileKey, Tile> tiles;
+    std::vector<TileKey> wanted;   // від центру видимої області до країв
+    TileKey centre{0, 0};
+    std::atomic<bool> stopping{false};
+};
+
+#endif // PLOTTILES_H
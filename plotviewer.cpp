@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "plotviewer.h"
+#include "plotrenderer.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <algorithm>
+
+namespace {
+
+const int MinLevel = -40;   // 10 / 2^10 пікселя на одиницю
+const int MaxLevel = 80;    // 10 * 2^20 пікселів на одиницю
+
+}
+
+PlotViewer::PlotViewer(Evaluator& eval, PlotSpec spec, std::vector<QColor> colors,
+                       int width, int height, QWidget *parent)
+    : QWidget(parent, Qt::Window), colors(std::move(colors)) {
+    // плитки готуються у фоновому потоці, а малюються в потоці вікна
+    tiles = PlotTiles::create(eval, std::move(spec), [this] {
+        QMetaObject::invokeMethod(this, [this] { update(); }, Qt::QueuedConnection);
+    });
+
+    resize(width, height);
+    setCursor(Qt::OpenHandCursor);
+
+    // перший кадр обчислюється одразу, і помилку функції бачить REPL. Деструктор
+    // недобудованого вікна не виконається, тож фоновий потік зупиняється тут
+    try {
+        tiles->prime(level, view());
+    } catch (...) {
+        tiles->stop();
+        throw;
+    }
+}
+
+PlotViewer::~PlotViewer() {
+    // фоновий потік завершується сам, вікно на нього не чекає
+    tiles->stop();
+}
+
+PlotView PlotViewer::view() const {
+    const double s = PlotTiles::scale(level);
+    const int wid = width();
+    const int heg = height();
+    const double xMin = centreX - (wid / 2) / s;
+    const double yMax = centreY + (heg / 2) / s;
+    return PlotView{xMin, xMin + wid / s, yMax - heg / s, yMax, wid, heg};
+}
+
+void PlotViewer::requestTiles() {
+    tiles->request(level, view());
+    update();
+}
+
+void PlotViewer::paintEvent(QPaintEvent *event) {
+    (void)event;
+    const PlotView current = view();
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    PlotRenderer::paint(painter, current, tiles->curves(level, current), colors);
+}
+
+void PlotViewer::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    requestTiles();
+}
+
+void PlotViewer::mousePressEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton)
+        return;
+    dragging = true;
+    dragStart = event->pos();
+    dragCentreX = centreX;
+    dragCentreY = centreY;
+    setCursor(Qt::ClosedHandCursor);
+}
+
+void PlotViewer::mouseMoveEvent(QMouseEvent *event) {
+    if (!dragging)
+        return;
+    const double s = PlotTiles::scale(level);
+    const QPointF delta = QPointF(event->pos()) - dragStart;
+    centreX = dragCentreX - delta.x() / s;
+    centreY = dragCentreY + delta.y() / s;
+    requestTiles();
+}
+
+void PlotViewer::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton)
+        return;
+    dragging = false;
+    setCursor(Qt::OpenHandCursor);
+}
+
+void PlotViewer::wheelEvent(QWheelEvent *event) {
+    // тачпад дає дрібні кроки: рівень змінюється на кожні повні 120
+    wheelDelta += event->angleDelta().y();
+    const int steps = wheelDelta / 120;
+    wheelDelta -= steps * 120;
+    const int next = std::max(MinLevel, std::min(MaxLevel, level + steps));
+    if (next == level)
+        return;
+
+    // точка функції під курсором лишається під курсором
+    const QPointF cursor = event->position();
+    const double halfWidth = width() / 2;
+    const double halfHeight = height() / 2;
+    const double before = PlotTiles::scale(level);
+    const double after = PlotTiles::scale(next);
+    const double x = centreX + (cursor.x() - halfWidth) / before;
+    const double y = centreY - (cursor.y() - halfHeight) / before;
+    centreX = x - (cursor.x() - halfWidth) / after;
+    centreY = y + (cursor.y() - halfHeight) / after;
+    level = next;
+    requestTiles();
+}
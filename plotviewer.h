@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef PLOTVIEWER_H
+#define PLOTVIEWER_H
+
+#include "plottiles.h"
+#include <QColor>
+#include <QPointF>
+#include <QWidget>
+#include <memory>
+#include <vector>
+
+// Вікно графіків з перетягуванням мишею та масштабом колесом відносно курсора.
+// Малюються лише вже обчислені точки PlotTiles, тож перетягування не чекає на
+// функцію; нові ділянки з'являються спершу грубо, потім уточнюються.
+class PlotViewer : public QWidget
+{
+public:
+    PlotViewer(Evaluator& eval, PlotSpec spec, std::vector<QColor> colors,
+               int width, int height, QWidget *parent = nullptr);
+    ~PlotViewer() override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+
+private:
+    PlotView view() const;
+    void requestTiles();
+
+    double centreX = 0;    // точка функції в центрі вікна
+    double centreY = 0;
+    int level = 0;         // рівень масштабу PlotTiles
+
+    bool dragging = false;
+    QPointF dragStart;
+    double dragCentreX = 0;
+    double dragCentreY = 0;
+    int wheelDelta = 0;
+
+    std::vector<QColor> colors;
+
+    std::shared_ptr<PlotTiles> tiles; // спільний з фоновим потоком, див. PlotTiles::stop
+};
+
+#endif // PLOTVIEWER_H
@@ -1,536 +1,405 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "primitive.h"
-#include "utils.h"
-#include <cmath>
-#include <QWidget>
-#include <QEventLoop>
-#include <QPainter>
-#include <QLabel>
-#include <QImage>
-#include <QVBoxLayout>
-
-Primitive::Primitive() {}
-
-// ====================================== main ======================================
-Value Primitive::std_define(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 2)
-        throw std::runtime_error("'define' requires exactly 2 arguments: (define name value)");
-
-    auto name = args[0];
-    auto valueExpr = args[1];
-
-    if (!name->isAtom())
-        throw std::runtime_error("'define' first argument must be a symbol");
-
-    std::string varName = name->asAtom();
-    Value val = eval.Eval(valueExpr, env);
-
-    env->define(varName, val);
-
-    return val;
-}
-
-Value Primitive::std_begin(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'begin': at least one argument is required");
-    Value result;
-    std::shared_ptr<Environment> newEnv = std::make_shared<Environment>(env);
-    for(auto arg: args) {
-        result = eval.Eval(arg, newEnv);
-    }
-    return result;
-}
-
-Value Primitive::std_cond(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'cond': at least one argument is required");
-
-    for (auto& clause : args) {
-        if (clause->isAtom())
-            throw std::runtime_error("'cond': each clause must be a list");
-
-        auto inner = clause->asList();
-        if (inner.empty())
-            throw std::runtime_error("'cond': clause must not be empty");
-
-        auto condition = inner[0];
-
-        if (condition->isAtom() && condition->asAtom() == "else") {
-            if (inner.size() < 2)
-                throw std::runtime_error("'cond': 'else' clause must have a body");
-            return eval.Eval(inner[1], env);
-        }
-
-        Value condResult = eval.Eval(condition, env);
-
-        if (!condResult.isBool() || condResult.asBool()) {
-            if (inner.size() < 2)
-                throw std::runtime_error("'cond': true condition must have a body");
-            return eval.Eval(inner[1], env);
-        }
-    }
-
-    return Value();
-}
-
-// ==================================== cond ===================================
-Value Primitive::std_equal(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 2)
-        throw std::runtime_error("'=' expects exactly 2 arguments");
-
-    Value left = eval.Eval(args[0], env);
-    Value right = eval.Eval(args[1], env);
-
-    if (left.isNumber() && right.isNumber())
-        return Value(left.asNumber() == right.asNumber());
-    if (left.isBool() && right.isBool())
-        return Value(left.asBool() == right.asBool());
-    if (left.isString() && right.isString())
-        return Value(left.asString() == right.asString());
-
-    return Value(false); // not equal if types differ
-}
-
-Value Primitive::std_gt(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    std::vector<Value> vals;
-    for (auto& arg : args)
-        vals.push_back(eval.Eval(arg, env));
-    return ensureSingleTypeAndCompare(vals, [](auto a, auto b){ return a > b; });
-}
-
-Value Primitive::std_lt(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    std::vector<Value> vals;
-    for (auto& arg : args)
-        vals.push_back(eval.Eval(arg, env));
-    return ensureSingleTypeAndCompare(vals, [](auto a, auto b){ return a < b; });
-}
-
-Value Primitive::std_ge(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    std::vector<Value> vals;
-    for (auto& arg : args)
-        vals.push_back(eval.Eval(arg, env));
-    return ensureSingleTypeAndCompare(vals, [](auto a, auto b){ return a >= b; });
-}
-
-Value Primitive::std_le(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    std::vector<Value> vals;
-    for (auto& arg : args)
-        vals.push_back(eval.Eval(arg, env));
-    return ensureSingleTypeAndCompare(vals, [](auto a, auto b){ return a <= b; });
-}
-
-Value Primitive::std_and(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'and': at least one argument is required");
-
-    for (auto& arg : args) {
-        Value value = eval.Eval(arg, env);
-        if (value.isBool() && value.asBool() == false)
-            return false;
-    }
-    return Value(true);
-}
-
-Value Primitive::std_or(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'and': at least one argument is required");
-
-    for (auto& arg : args) {
-        Value value = eval.Eval(arg, env);
-        if (value.isBool() && value.asBool() == true)
-            return true;
-    }
-    return Value(false);
-}
-
-Value Primitive::std_not(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'not' expects exactly 1 arguments");
-    Value value = eval.Eval(args[0], env);
-    if (value.isBool() && value.asBool() == false)
-        return true;
-    else
-        return false;
-}
-
-Value Primitive::std_is_number(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'number?': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    return Value(val.isNumber());
-}
-
-Value Primitive::std_is_string(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'string?': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    return Value(val.isString());
-}
-
-Value Primitive::std_is_bool(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'bool?': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    return Value(val.isBool());
-}
-
-Value Primitive::std_is_lambda(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'lambda?': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    return Value(val.isLambda());
-}
-
-// ====================================== math ======================================
-Value Primitive::std_plus(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    long double result = 0;
-    for (const auto& arg : args) {
-        Value valArg = eval.Eval(arg, env);
-        if (!valArg.isNumber())
-            throw std::runtime_error(" '+' only works with numbers");
-        result += valArg.asNumber();
-    }
-    return result;
-}
-
-Value Primitive::std_minus(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'-': at least one argument is required");
-
-    Value resultVal = eval.Eval(args[0], env);
-    if (!resultVal.isNumber())
-        throw std::runtime_error("'-': the first argument must be a number");
-
-    long double result = resultVal.asNumber();
-
-    if (args.size() == 1) {
-        return Value(-result);
-    }
-
-    for (size_t i = 1; i < args.size(); ++i) {
-        Value val = eval.Eval(args[i], env);
-        if (!val.isNumber())
-            throw std::runtime_error("'-': all arguments must be numbers");
-        result -= val.asNumber();
-    }
-
-    return Value(result);
-}
-
-Value Primitive::std_mul(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    long double result = 1;
-    for (const auto& arg : args) {
-        Value valArg = eval.Eval(arg, env);
-        if (!valArg.isNumber())
-            throw std::runtime_error(" '*' only works with numbers");
-        result *= valArg.asNumber();
-    }
-    return result;
-}
-
-Value Primitive::std_div(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.empty())
-        throw std::runtime_error("'/' expects at least one argument");
-    Value firstVal = eval.Eval(args[0], env);
-    if (!firstVal.isNumber())
-        throw std::runtime_error("'/' expects all arguments to be numbers");
-
-    long double result = firstVal.asNumber();
-
-    if (args.size() == 1) {
-        if (result == 0)
-            throw std::runtime_error("'/' division by zero");
-        return Value(1.0L / result);
-    }
-
-    for (size_t i = 1; i < args.size(); ++i) {
-        Value val = eval.Eval(args[i], env);
-        if (!val.isNumber())
-            throw std::runtime_error("'/' expects all arguments to be numbers");
-
-        long double divisor = val.asNumber();
-        if (divisor == 0)
-            throw std::runtime_error("'/' division by zero");
-
-        result /= divisor;
-    }
-
-    return Value(result);
-}
-
-Value Primitive::std_sqrt(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'sqrt': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'sqrt': argument must be a number");
-
-    return Value(std::sqrt(val.asNumber()));
-}
-
-Value Primitive::std_pow(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 2)
-        throw std::runtime_error("'pow': requires exactly 2 arguments");
-
-    Value base = eval.Eval(args[0], env);
-    Value exponent = eval.Eval(args[1], env);
-
-    if (!base.isNumber() || !exponent.isNumber())
-        throw std::runtime_error("'pow': both arguments must be numbers");
-
-    return Value(std::pow(base.asNumber(), exponent.asNumber()));
-}
-
-Value Primitive::std_sin(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'sin': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'sin': argument must be a number");
-
-    return Value(std::sin(val.asNumber()));
-}
-
-Value Primitive::std_cos(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'cos': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'cos': argument must be a number");
-
-    return Value(std::cos(val.asNumber()));
-}
-
-Value Primitive::std_tan(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'tan': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'tan': argument must be a number");
-
-    return Value(std::tan(val.asNumber()));
-}
-
-Value Primitive::std_asin(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'asin': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'asin': argument must be a number");
-
-    return Value(std::asin(val.asNumber()));
-}
-
-Value Primitive::std_acos(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'acos': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'acos': argument must be a number");
-
-    return Value(std::acos(val.asNumber()));
-}
-
-Value Primitive::std_atan(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'atan': requires exactly 1 argument");
-
-    Value val = eval.Eval(args[0], env);
-    if (!val.isNumber())
-        throw std::runtime_error("'atan': argument must be a number");
-
-    return Value(std::atan(val.asNumber()));
-}
-
-// ====================================== system ======================================
-Value Primitive::std_exit(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    env->has("");
-    eval.isPrimitive("");
-    if (!args.empty())
-        throw std::runtime_error("'/' no need to have arguments");
-    exit(0);
-}
-
-Value Primitive::std_load_file(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 1)
-        throw std::runtime_error("'load-file' requires exactly 1 argument");
-
-    Value filename = eval.Eval(args[0], env);
-    if (!filename.isString())
-        throw std::runtime_error("'load-file' filename is not a string");
-
-    const char* fname = filename.asString().c_str();
-    FILE* file = fopen(fname, "rb");
-
-    if (!file) {
-        throw std::runtime_error("Could not open file: " + filename.asString());
-    }
-
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
-
-    std::string content;
-    content.resize(size);
-    size_t readBytes = fread(&content[0], 1, size, file);
-    fclose(file);
-
-    if (readBytes != (size_t)size) {
-        throw std::runtime_error("Error reading file: " + filename.asString());
-    }
-
-    auto tokens = tokenizeLisp(content);
-    TokenStream ts(tokens);
-
-    while (ts.hasNext()) {
-        auto exp = ListObject::parse_tokens(ts);
-        std::shared_ptr<Environment> _env = std::shared_ptr<Environment>(env);
-        auto result = eval.Eval(exp, _env);
-    }
-
-    return Value(true);
-}
-
-Value Primitive::std_draw_plot(std::vector<std::shared_ptr<ListObject>> args, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (args.size() != 3)
-        throw std::runtime_error("'draw-plot' requires exactly 3 arguments");
-
-    Value wd = eval.Eval(args[0], env);
-    Value hg = eval.Eval(args[1], env);
-    Value lm = eval.Eval(args[2], env);
-
-    if (!wd.isNumber() || !hg.isNumber() || !lm.isLambda())
-        return Value(false);
-
-    QWidget *window = new QWidget();
-    window->setFixedSize(wd.asNumber(), hg.asNumber());
-    window->setWindowTitle("Plot Window");
-
-    QImage image(wd.asNumber(), hg.asNumber(), QImage::Format_RGB32);
-    image.fill(Qt::white);
-
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing);
-    QPen pen(Qt::blue);
-    pen.setWidth(1);
-    painter.setPen(pen);
-
-    const long wid = (long)wd.asNumber();
-    const long heg = (long)hg.asNumber();
-    const std::shared_ptr<Lambda> lambda = lm.asLambda();
-
-    const double step = 0.1;
-    const long center_x = wid / 2;
-    const long center_y = heg / 2;
-    QPen oldPen = painter.pen();
-
-    QPen gridPen(Qt::gray, 1, Qt::DotLine);
-    painter.setPen(gridPen);
-
-    for (long x = 0; x < wid; x += 10) {
-        painter.drawLine(x, 0, x, heg - 1);
-    }
-
-    for (long y = 0; y < heg; y += 10) {
-        painter.drawLine(0, y, wid - 1, y);
-    }
-
-    QPen axisPen(Qt::black, 2);
-    painter.setPen(axisPen);
-    painter.drawLine(0, center_y, wid-1, center_y);
-    painter.drawLine(center_x, 0, center_x, heg-1);
-
-    painter.setPen(oldPen);
-
-
-    const double x_scale = 10.0;
-    const double y_scale = 10.0;
-    const double x_min = -center_x / x_scale;
-    const double x_max = (wid - center_x) / x_scale;
-
-    bool has_previous = false;
-    long prev_px = 0, prev_py = 0;
-
-    for (double x = x_min; x <= x_max; x += step) {
-        Value y = eval.ApplyLambda(lambda, std::vector<Value>{Value((long double)x)}, env, eval);
-
-        if (y.isNumber()) {
-            double y_val = y.asNumber();
-
-            if (!std::isfinite(y_val)) {
-                has_previous = false;
-                continue;
-            }
-
-            long pixel_x = center_x + static_cast<long>(x * x_scale);
-            long pixel_y = center_y - static_cast<long>(y_val * y_scale);
-
-            pixel_x = std::max(0L, std::min(wid - 1, pixel_x));
-            pixel_y = std::max(0L, std::min(heg - 1, pixel_y));
-
-            if (has_previous) {
-                painter.drawLine(prev_px, prev_py, pixel_x, pixel_y);
-            }
-
-            prev_px = pixel_x;
-            prev_py = pixel_y;
-            has_previous = true;
-        }
-        else {
-            has_previous = false;
-        }
-    }
-
-    painter.drawLine(0, center_y, wid-1, center_y);
-    painter.drawLine(center_x, 0, center_x, heg-1);
-
-    painter.setPen(oldPen);
-    painter.end();
-
-    QWidget *imageWindow = new QWidget(window);
-    imageWindow->resize(wd.asNumber(), hg.asNumber());
-
-    QLabel *imageLabel = new QLabel(imageWindow);
-    imageLabel->setPixmap(QPixmap::fromImage(image));
-
-    QVBoxLayout *layout = new QVBoxLayout(imageWindow);
-    layout->addWidget(imageLabel);
-    imageWindow->setLayout(layout);
-
-    imageWindow->show();
-    window->show();
-    QEventLoop loop;
-    loop.exec();
-
-    return Value(true);
-}
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "primitive.h"
+#include "utils.h"
+#include "plotmanager.h"
+#include "plotrenderer.h"
+#include <QSize>
+#include <atomic>
+#include <cmath>
+
+Primitive::Primitive() {}
+
+// ====================================== main ======================================
+Value Primitive::std_define(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 2)
+        throw std::runtime_error("'define' requires exactly 2 arguments: (define name value)");
+
+    auto name = args[0];
+    auto valueExpr = args[1];
+
+    if (!name->isAtom() || name->atomType() != ListObject::AtomType::Symbol)
+        throw std::runtime_error("'define' first argument must be a symbol");
+
+    Value val = eval.Eval(valueExpr, env);
+
+    if (name->slot() >= 0)
+        env->defineSlot(name->slot(), val);
+    else
+        env->define(name->asSymbol(), val);
+
+    return val;
+}
+
+// ==================================== cond ===================================
+namespace {
+
+// ланцюжок порівнянь (< a b c): типи вже перевірив Evaluator
+template <typename Compare>
+Value compareChain(const Value* args, size_t argc, Compare compare) {
+    for (size_t i = 1; i < argc; ++i)
+        if (!compare(args[i - 1].asNumber(), args[i].asNumber()))
+            return Value(false);
+    return Value(true);
+}
+
+}
+
+Value Primitive::std_equal(const Value* args, size_t) {
+    const Value& left = args[0];
+    const Value& right = args[1];
+
+    if (left.isNumber() && right.isNumber())
+        return Value(left.asNumber() == right.asNumber());
+    if (left.isBool() && right.isBool())
+        return Value(left.asBool() == right.asBool());
+    if (left.isString() && right.isString())
+        return Value(left.asString() == right.asString());
+
+    return Value(false); // not equal if types differ
+}
+
+Value Primitive::std_gt(const Value* args, size_t argc) {
+    return compareChain(args, argc, [](Number a, Number b){ return a > b; });
+}
+
+Value Primitive::std_lt(const Value* args, size_t argc) {
+    return compareChain(args, argc, [](Number a, Number b){ return a < b; });
+}
+
+Value Primitive::std_ge(const Value* args, size_t argc) {
+    return compareChain(args, argc, [](Number a, Number b){ return a >= b; });
+}
+
+Value Primitive::std_le(const Value* args, size_t argc) {
+    return compareChain(args, argc, [](Number a, Number b){ return a <= b; });
+}
+
+Value Primitive::std_and(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.empty())
+        throw std::runtime_error("'and': at least one argument is required");
+
+    for (ListObject* arg : args) {
+        Value value = eval.Eval(arg, env);
+        if (value.isBool() && value.asBool() == false)
+            return false;
+    }
+    return Value(true);
+}
+
+Value Primitive::std_or(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.empty())
+        throw std::runtime_error("'and': at least one argument is required");
+
+    for (ListObject* arg : args) {
+        Value value = eval.Eval(arg, env);
+        if (value.isBool() && value.asBool() == true)
+            return true;
+    }
+    return Value(false);
+}
+
+Value Primitive::std_not(const Value* args, size_t) {
+    return Value(args[0].isBool() && args[0].asBool() == false);
+}
+
+Value Primitive::std_is_number(const Value* args, size_t) {
+    return Value(args[0].isNumber());
+}
+
+Value Primitive::std_is_string(const Value* args, size_t) {
+    return Value(args[0].isString());
+}
+
+Value Primitive::std_is_bool(const Value* args, size_t) {
+    return Value(args[0].isBool());
+}
+
+Value Primitive::std_is_lambda(const Value* args, size_t) {
+    return Value(args[0].isLambda());
+}
+
+// ====================================== math ======================================
+Value Primitive::std_plus(const Value* args, size_t argc) {
+    Number result = 0;
+    for (size_t i = 0; i < argc; ++i)
+        result += args[i].asNumber();
+    return Value(result);
+}
+
+Value Primitive::std_minus(const Value* args, size_t argc) {
+    Number result = args[0].asNumber();
+    if (argc == 1)
+        return Value(-result);
+
+    for (size_t i = 1; i < argc; ++i)
+        result -= args[i].asNumber();
+    return Value(result);
+}
+
+Value Primitive::std_mul(const Value* args, size_t argc) {
+    Number result = 1;
+    for (size_t i = 0; i < argc; ++i)
+        result *= args[i].asNumber();
+    return Value(result);
+}
+
+Value Primitive::std_div(const Value* args, size_t argc) {
+    Number result = args[0].asNumber();
+
+    if (argc == 1) {
+        if (result == 0)
+            throw std::runtime_error("'/' division by zero");
+        return Value(1 / result);
+    }
+
+    for (size_t i = 1; i < argc; ++i) {
+        Number divisor = args[i].asNumber();
+        if (divisor == 0)
+            throw std::runtime_error("'/' division by zero");
+        result /= divisor;
+    }
+
+    return Value(result);
+}
+
+Value Primitive::std_sqrt(const Value* args, size_t) {
+    return Value(std::sqrt(args[0].asNumber()));
+}
+
+Value Primitive::std_pow(const Value* args, size_t) {
+    return Value(std::pow(args[0].asNumber(), args[1].asNumber()));
+}
+
+Value Primitive::std_sin(const Value* args, size_t) {
+    return Value(std::sin(args[0].asNumber()));
+}
+
+Value Primitive::std_cos(const Value* args, size_t) {
+    return Value(std::cos(args[0].asNumber()));
+}
+
+Value Primitive::std_tan(const Value* args, size_t) {
+    return Value(std::tan(args[0].asNumber()));
+}
+
+Value Primitive::std_asin(const Value* args, size_t) {
+    return Value(std::asin(args[0].asNumber()));
+}
+
+Value Primitive::std_acos(const Value* args, size_t) {
+    return Value(std::acos(args[0].asNumber()));
+}
+
+Value Primitive::std_atan(const Value* args, size_t) {
+    return Value(std::atan(args[0].asNumber()));
+}
+
+// ====================================== system ======================================
+Value Primitive::std_exit(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    (void)env;
+    (void)eval;
+    if (!args.empty())
+        throw std::runtime_error("'/' no need to have arguments");
+    exit(0);
+}
+
+Value Primitive::std_load_file(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 1)
+        throw std::runtime_error("'load-file' requires exactly 1 argument");
+
+    Value filename = eval.Eval(args[0], env);
+    if (!filename.isString())
+        throw std::runtime_error("'load-file' filename is not a string");
+
+    evalFile(filename.asString(), env, eval);
+    return Value(true);
+}
+
+namespace {
+
+const int MaxPlotSize = 16384;
+
+// Розмір полотна перевіряється до вибірки: NaN, від'ємне чи величезне число
+// не можна перетворити в int, а кількість точок сітки росте з шириною
+QSize plotSize(const char* name, Number width, Number height) {
+    if (!(width >= 1 && width <= MaxPlotSize && height >= 1 && height <= MaxPlotSize))
+        throw std::runtime_error(std::string("'") + name + "': width and height must be between 1 and " + std::to_string(MaxPlotSize));
+    return QSize(static_cast<int>(width), static_cast<int>(height));
+}
+
+// вікно, якщо REPL має PlotManager, інакше (пакетний режим) файл plot-1.png, plot-2.png, ...
+Value showPlot(Evaluator& eval, const char* name, Number width, Number height, PlotSpec spec, std::vector<QColor> colors) {
+    const QSize size = plotSize(name, width, height);
+    if (PlotManager* plots = eval.getPlotManager()) {
+        plots->show(eval, std::move(spec), std::move(colors), size.width(), size.height());
+        return Value(true);
+    }
+
+    PlotRenderer plot(size.width(), size.height());
+    plot.sample(eval, spec, std::move(colors));
+
+    static std::atomic<int> counter{0};
+    return Value(plot.save(QString("plot-%1.png").arg(++counter)));
+}
+
+}
+
+Value Primitive::std_draw_plot(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 3)
+        throw std::runtime_error("'draw-plot' requires exactly 3 arguments");
+
+    Value wd = eval.Eval(args[0], env);
+    Value hg = eval.Eval(args[1], env);
+    Value lm = eval.Eval(args[2], env);
+
+    if (!wd.isNumber() || !hg.isNumber() || !lm.isLambda())
+        return Value(false);
+
+    return showPlot(eval, "draw-plot", wd.asNumber(), hg.asNumber(), PlotSpec{PlotSpec::Kind::Explicit, {lm.asLambda()}}, {PlotRenderer::defaultColor(0)});
+}
+
+Value Primitive::std_draw_plots(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() < 3)
+        throw std::runtime_error("'draw-plots' requires width, height and at least one function");
+
+    Value wd = eval.Eval(args[0], env);
+    Value hg = eval.Eval(args[1], env);
+    if (!wd.isNumber() || !hg.isNumber())
+        return Value(false);
+
+    // за кожною функцією може йти її колір: "red", "#ff8000", ...
+    std::vector<std::shared_ptr<Lambda>> functions;
+    std::vector<QColor> colors;
+    bool colored = true;
+    for (size_t i = 2; i < args.size(); ++i) {
+        Value arg = eval.Eval(args[i], env);
+        if (arg.isLambda()) {
+            functions.push_back(arg.asLambda());
+            colors.push_back(PlotRenderer::defaultColor(colors.size()));
+            colored = false;
+        } else if (arg.isString() && !colored) {
+            QColor color(QString::fromStdString(arg.asString()));
+            if (!color.isValid())
+                throw std::runtime_error("'draw-plots': unknown color \"" + arg.asString() + "\"");
+            colors.back() = color;
+            colored = true;
+        } else {
+            return Value(false);
+        }
+    }
+
+    return showPlot(eval, "draw-plots", wd.asNumber(), hg.asNumber(), PlotSpec{PlotSpec::Kind::Explicit, std::move(functions)}, std::move(colors));
+}
+
+Value Primitive::std_draw_parametric(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 6)
+        throw std::runtime_error("'draw-parametric' requires exactly 6 arguments");
+
+    Value wd = eval.Eval(args[0], env);
+    Value hg = eval.Eval(args[1], env);
+    Value fx = eval.Eval(args[2], env);
+    Value fy = eval.Eval(args[3], env);
+    Value from = eval.Eval(args[4], env);
+    Value to = eval.Eval(args[5], env);
+
+    if (!wd.isNumber() || !hg.isNumber() || !fx.isLambda() || !fy.isLambda() || !from.isNumber() || !to.isNumber())
+        return Value(false);
+
+    const double tMin = static_cast<double>(from.asNumber());
+    const double tMax = static_cast<double>(to.asNumber());
+    if (!std::isfinite(tMin) || !std::isfinite(tMax) || !(tMin < tMax))
+        throw std::runtime_error("'draw-parametric': t-min must be less than t-max");
+
+    PlotSpec spec{PlotSpec::Kind::Parametric, {fx.asLambda(), fy.asLambda()}, tMin, tMax};
+    return showPlot(eval, "draw-parametric", wd.asNumber(), hg.asNumber(), std::move(spec), {PlotRenderer::defaultColor(0)});
+}
+
+Value Primitive::std_draw_implicit(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 3)
+        throw std::runtime_error("'draw-implicit' requires exactly 3 arguments");
+
+    Value wd = eval.Eval(args[0], env);
+    Value hg = eval.Eval(args[1], env);
+    Value lm = eval.Eval(args[2], env);
+
+    if (!wd.isNumber() || !hg.isNumber() || !lm.isLambda())
+        return Value(false);
+
+    return showPlot(eval, "draw-implicit", wd.asNumber(), hg.asNumber(), PlotSpec{PlotSpec::Kind::Implicit, {lm.asLambda()}}, {PlotRenderer::defaultColor(0)});
+}
+
+Value Primitive::std_draw_plot_to_file(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 4)
+        throw std::runtime_error("'draw-plot-to-file' requires exactly 4 arguments");
+
+    Value path = eval.Eval(args[0], env);
+    Value wd = eval.Eval(args[1], env);
+    Value hg = eval.Eval(args[2], env);
+    Value lm = eval.Eval(args[3], env);
+
+    if (!path.isString() || !wd.isNumber() || !hg.isNumber() || !lm.isLambda())
+        return Value(false);
+
+    const QSize size = plotSize("draw-plot-to-file", wd.asNumber(), hg.asNumber());
+    PlotRenderer plot(size.width(), size.height());
+    plot.sample(eval, PlotSpec{PlotSpec::Kind::Explicit, {lm.asLambda()}}, {PlotRenderer::defaultColor(0)});
+    return Value(plot.save(QString::fromStdString(path.asString())));
+}
+
+Value Primitive::std_set_backend(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 1)
+        throw std::runtime_error("'set-backend' requires exactly 1 argument");
+
+    Value name = eval.Eval(args[0], env);
+    if (!name.isString())
+        throw std::runtime_error("'set-backend' argument must be a string");
+
+    if (name.asString() == "tree")
+        eval.setBackend(Evaluator::Backend::Tree);
+    else if (name.asString() == "vm")
+        eval.setBackend(Evaluator::Backend::VM);
+    else
+        throw std::runtime_error("'set-backend' expects \"tree\" or \"vm\"");
+
+    return Value(true);
+}
+
+Value Primitive::std_set_folding(ListObject::List args, const std::shared_ptr<Environment>& env, Evaluator& eval) {
+    if (args.size() != 1)
+        throw std::runtime_error("'set-folding' requires exactly 1 argument");
+
+    Value mode = eval.Eval(args[0], env);
+    if (!mode.isString())
+        throw std::runtime_error("'set-folding' argument must be a string");
+
+    if (mode.asString() == "on")
+        eval.setFolding(Evaluator::Folding::On);
+    else if (mode.asString() == "off")
+        eval.setFolding(Evaluator::Folding::Off);
+    else if (mode.asString() == "report")
+        eval.setFolding(Evaluator::Folding::Report);
+    else
+        throw std::runtime_error("'set-folding' expects \"on\", \"off\" or \"report\"");
+
+    return Value(true);
+}
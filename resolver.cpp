@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "resolver.h"
+#include "utils.h"
+#include "lambda.h"
+#include <algorithm>
+
+Resolver::Resolver(const std::shared_ptr<AstArena>& arena) : arena(arena) {}
+
+void Resolver::resolve(ListObject* exp, const std::shared_ptr<AstArena>& arena) {
+    Resolver resolver(arena);
+    resolver.resolveExpr(exp);
+}
+
+void Resolver::resolveExpr(ListObject* exp) {
+    if (exp->isAtom()) {
+        if (exp->atomType() == ListObject::AtomType::Symbol)
+            resolveSymbol(exp);
+        return;
+    }
+
+    const auto& list = exp->asList();
+    if (isLambda(exp)) {
+        Scope scope{{}, true, false};
+        for (const auto& param : list[1]->asList())
+            scope.names.push_back(param->asSymbol());
+        resolveScope(list, 2, std::move(scope), exp);
+        exp->setPrototype(Lambda::makePrototype(exp, arena));
+    } else if (isBegin(exp)) {
+        resolveScope(list, 1, Scope{{}, false, false}, exp);
+    } else {
+        for (const auto& item : list)
+            resolveExpr(item);
+    }
+}
+
+void Resolver::resolveScope(const ListObject::List& forms, size_t first, Scope scope, ListObject* owner) {
+    collectDefines(forms, first, scope.names);
+    owner->setFrame(std::make_shared<const std::vector<Symbol>>(scope.names));
+
+    scopes.push_back(std::move(scope));
+    for (size_t i = first; i < forms.size(); ++i)
+        resolveExpr(forms[i]);
+    owner->setCapturesLocals(scopes.back().capturesLocals);
+    scopes.pop_back();
+}
+
+void Resolver::resolveSymbol(ListObject* atom) {
+    Symbol name = atom->asSymbol();
+    int depth = 0;
+
+    for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope, ++depth) {
+        auto it = std::find(scope->names.begin(), scope->names.end(), name);
+        if (it != scope->names.end()) {
+            atom->setAddress(depth, static_cast<int>(it - scope->names.begin()));
+            // кожна LAMBDA між посиланням і кадром змінної має тримати цей кадр
+            for (auto inner = scopes.rbegin(); inner != scope; ++inner)
+                if (inner->isLambda)
+                    inner->capturesLocals = true;
+            return;
+        }
+    }
+}
+
+void Resolver::collectDefines(const ListObject::List& forms, size_t first, std::vector<Symbol>& names) {
+    for (size_t i = first; i < forms.size(); ++i) {
+        const auto& form = forms[i];
+        if (form->isAtom() || isLambda(form) || isBegin(form))
+            continue;
+
+        const auto& list = form->asList();
+        if (list.size() == 3 && list[0]->isAtom() && list[0]->asSymbol() == Sym::DEFINE
+            && list[1]->isAtom() && list[1]->atomType() == ListObject::AtomType::Symbol) {
+            Symbol name = list[1]->asSymbol();
+            if (std::find(names.begin(), names.end(), name) == names.end())
+                names.push_back(name);
+        }
+
+        collectDefines(list, 0, names);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "listobject.h"
+#include <vector>
+
+// Прохід перед виконанням: кожному посиланню на параметр чи локальну змінну
+// LAMBDA або BEGIN призначається адреса (глибина кадру, слот), тож під час
+// виконання такі змінні читаються з масиву без пошуку за іменем.
+// Кадр виклику лямбди є дочірнім до середовища, де її створено,
+// тому адреса може вести й за межі LAMBDA, у кадри охоплюючих форм.
+// Глобальні змінні верхнього рівня лишаються у хеш-таблиці середовища.
+class Resolver
+{
+public:
+    // arena - арена, в якій розібрано exp; її тримають прототипи лямбд
+    static void resolve(ListObject* exp, const std::shared_ptr<AstArena>& arena);
+
+    // імена, які DEFINE у forms[first..] визначає в кадрі цих форм (вкладені
+    // LAMBDA та BEGIN мають власні кадри й пропускаються)
+    static void collectDefines(const ListObject::List& forms, size_t first, std::vector<Symbol>& names);
+
+private:
+    struct Scope
+    {
+        std::vector<Symbol> names;
+        bool isLambda;
+        bool capturesLocals;
+    };
+
+    explicit Resolver(const std::shared_ptr<AstArena>& arena);
+
+    void resolveExpr(ListObject* exp);
+    void resolveScope(const ListObject::List& forms, size_t first, Scope scope, ListObject* owner);
+    void resolveSymbol(ListObject* atom);
+
+    const std::shared_ptr<AstArena>& arena;
+    std::vector<Scope> scopes;
+};
+
+#endif // RESOLVER_H
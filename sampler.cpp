@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "sampler.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+const double CoarseStepPx = 8.0;   // крок початкової сітки
+const double TolerancePx = 0.5;    // допустиме відхилення від хорди
+const int MaxDepth = 8;            // найдрібніший інтервал: 8 / 2^8 = 1/32 пікселя
+
+const size_t ParametricSteps = 1024;  // початкова сітка t
+const int ParametricDepth = 30;       // з таким запасом поділу крива гладка й при масштабі x 2^20
+const double MarginPx = 2.0;          // відрізок за межами полотна, але ближче, ніж це, ще малюється
+
+struct Interval
+{
+    PlotPoint a;
+    PlotPoint b;
+};
+
+// чи перетинає рамка скінченних точок (у пікселях) полотно view
+bool nearView(const PlotView& view, std::initializer_list<PlotPoint> pixels) {
+    double minX = std::numeric_limits<double>::infinity(), maxX = -minX;
+    double minY = minX, maxY = maxX;
+    for (const PlotPoint& p : pixels) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y))
+            continue;
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    return maxX >= -MarginPx && minX <= view.width + MarginPx
+        && maxY >= -MarginPx && minY <= view.height + MarginPx;
+}
+
+// відстань від p до відрізка ab: на прямій ділянці з нерівномірною швидкістю
+// середня точка лежить на хорді, хоч і не посередині
+double distanceToChord(const PlotPoint& p, const PlotPoint& a, const PlotPoint& b) {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double length = dx * dx + dy * dy;
+    double t = length > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length : 0;
+    t = std::max(0.0, std::min(1.0, t));
+    return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+
+}
+
+size_t PlotSpec::curveCount() const {
+    return kind == Kind::Explicit ? functions.size() : 1;
+}
+
+double PlotView::toPixelX(double x) const {
+    return (x - xMin) * width / (xMax - xMin);
+}
+
+double PlotView::toPixelY(double y) const {
+    return (yMax - y) * height / (yMax - yMin);
+}
+
+Sampler::Sampler(Evaluator& eval, std::vector<std::shared_ptr<Lambda>> functions)
+    : backend(eval.getBackend()), functions(std::move(functions)), kernel(Kernel::compile(this->functions)) {}
+
+size_t Sampler::size() const {
+    return functions.size();
+}
+
+void Sampler::setCancel(std::function<bool()> cancelled) {
+    this->cancelled = std::move(cancelled);
+}
+
+void Sampler::evaluate(const double* xs, double* const* ys, size_t n,
+                       const bool* const* wanted, std::vector<std::exception_ptr>* pointErrors) {
+    ThreadPool& pool = ThreadPool::instance();
+    const size_t count = functions.size();
+
+    // шматків більше, ніж потоків, щоб дорогі ділянки функції не гальмували всіх
+    const size_t wantedChunks = std::min(n, pool.size() * 4);
+    if (wantedChunks == 0 || count == 0)
+        return;
+    const size_t chunkSize = (n + wantedChunks - 1) / wantedChunks;
+    // після округлення розміру останні шматки могли б лишитися порожніми
+    const size_t chunks = (n + chunkSize - 1) / chunkSize;
+
+    std::mutex errorMutex;
+    std::vector<size_t> errorIndex(count, n);
+    std::vector<std::exception_ptr> errors(count);
+
+    pool.parallelFor(chunks, [&](size_t chunk) {
+        if (cancelled && cancelled())
+            throw SamplingCancelled();
+
+        const size_t begin = chunk * chunkSize;
+        const size_t end = std::min(n, begin + chunkSize);
+
+        // Evaluator створюється, лише коли точку рахує інтерпретатор
+        std::unique_ptr<Evaluator> local;
+        auto interpret = [&](size_t k, size_t i) {
+            if (!local) {
+                local = std::make_unique<Evaluator>();
+                local->setBackend(backend);
+            }
+            try {
+                Value y = local->ApplyLambda(functions[k], std::vector<Value>{Value(static_cast<Number>(xs[i]))}, *local);
+                ys[k][i] = y.isNumber() ? static_cast<double>(y.asNumber()) : std::numeric_limits<double>::quiet_NaN();
+                return true;
+            } catch (...) {
+                ys[k][i] = std::numeric_limits<double>::quiet_NaN();
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (i < errorIndex[k]) {
+                    errorIndex[k] = i;
+                    errors[k] = std::current_exception();
+                }
+                return false;
+            }
+        };
+
+        // ядро рахує весь шматок для всіх своїх функцій, а точки, де інтерпретатор
+        // кинув би помилку, перераховуються ним, щоб отримати саму помилку
+        const size_t m = end - begin;
+        std::unique_ptr<bool[]> failed;
+        if (kernel) {
+            failed.reset(new bool[count * m]);
+            std::vector<double*> out(count);
+            std::vector<bool*> outFailed(count);
+            for (size_t k = 0; k < count; ++k) {
+                out[k] = ys[k] + begin;
+                outFailed[k] = failed.get() + k * m;
+            }
+            const double* args[] = {xs + begin};
+            kernel->run(args, out.data(), outFailed.data(), m);
+        }
+
+        for (size_t k = 0; k < count; ++k) {
+            const bool compiled = kernel && kernel->covers(k);
+            for (size_t i = begin; i < end; ++i) {
+                if (wanted && wanted[k] && !wanted[k][i])
+                    continue;
+                if (compiled && !failed[k * m + i - begin])
+                    continue;
+                if (!interpret(k, i) && !pointErrors)
+                    break;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+                if (!std::isfinite(ys[k][i]))
+                    ys[k][i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    });
+
+    if (pointErrors) {
+        *pointErrors = std::move(errors);
+        return;
+    }
+    size_t first = 0;
+    for (size_t k = 1; k < count; ++k)
+        if (errorIndex[k] < errorIndex[first])
+            first = k;
+    if (errors[first])
+        std::rethrow_exception(errors[first]);
+}
+
+PlotCurves Sampler::grid(const PlotView& view, std::vector<std::exception_ptr>* failures) {
+    const size_t count = functions.size();
+    const size_t coarse = std::max<size_t>(2, static_cast<size_t>(std::ceil(view.width / CoarseStepPx)));
+    std::vector<double> xs(coarse + 1);
+    for (size_t i = 0; i <= coarse; ++i)
+        xs[i] = view.xMin + (view.xMax - view.xMin) * i / coarse;
+
+    std::vector<std::vector<double>> ys(count, std::vector<double>(xs.size()));
+    std::vector<double*> out(count);
+    for (size_t k = 0; k < count; ++k)
+        out[k] = ys[k].data();
+    std::vector<std::exception_ptr> errors;
+    evaluate(xs.data(), out.data(), xs.size(), nullptr, &errors);
+
+    // окремі точки з помилкою (полюс 1/x рівно в нулі) лише розривають лінію,
+    // а функцію, що падає на всій сітці, повідомляємо як помилку
+    for (size_t k = 0; k < count; ++k) {
+        if (std::any_of(ys[k].begin(), ys[k].end(), [](double y) { return std::isfinite(y); }))
+            errors[k] = nullptr;
+        else if (errors[k] && !failures)
+            std::rethrow_exception(errors[k]);
+    }
+    if (failures)
+        *failures = std::move(errors);
+
+    PlotCurves curves(count, std::vector<PlotPoint>(xs.size()));
+    for (size_t k = 0; k < count; ++k)
+        for (size_t i = 0; i < xs.size(); ++i)
+            curves[k][i] = {xs[i], ys[k][i]};
+    return curves;
+}
+
+PlotCurves Sampler::refine(const PlotView& view, PlotCurves grid) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const size_t count = functions.size();
+    PlotCurves curves = std::move(grid);
+    std::vector<std::exception_ptr> errors;
+
+    std::vector<std::vector<Interval>> intervals(count);
+    for (size_t k = 0; k < count; ++k)
+        for (size_t i = 1; i < curves[k].size(); ++i)
+            intervals[k].push_back({curves[k][i - 1], curves[k][i]});
+
+    for (int depth = 1; depth <= MaxDepth; ++depth) {
+        // усі функції ділять ту саму сітку навпіл, тож їхні середні точки
+        // здебільшого збігаються й обчислюються в одному x
+        std::vector<double> xs;
+        for (const auto& list : intervals)
+            for (const Interval& interval : list)
+                xs.push_back((interval.a.x + interval.b.x) / 2);
+        if (xs.empty())
+            break;
+        std::sort(xs.begin(), xs.end());
+        xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+        std::vector<std::vector<size_t>> at(count);
+        std::vector<std::unique_ptr<bool[]>> need(count);
+        std::vector<const bool*> wanted(count);
+        std::vector<std::vector<double>> ys(count, std::vector<double>(xs.size()));
+        std::vector<double*> out(count);
+        for (size_t k = 0; k < count; ++k) {
+            need[k].reset(new bool[xs.size()]());
+            wanted[k] = need[k].get();
+            out[k] = ys[k].data();
+            for (const Interval& interval : intervals[k]) {
+                const double mid = (interval.a.x + interval.b.x) / 2;
+                const size_t i = std::lower_bound(xs.begin(), xs.end(), mid) - xs.begin();
+                at[k].push_back(i);
+                need[k][i] = true;
+            }
+        }
+        evaluate(xs.data(), out.data(), xs.size(), wanted.data(), &errors);
+
+        for (size_t k = 0; k < count; ++k) {
+            std::vector<PlotPoint>& points = curves[k];
+            std::vector<Interval> next;
+            for (size_t j = 0; j < intervals[k].size(); ++j) {
+                const PlotPoint a = intervals[k][j].a;
+                const PlotPoint b = intervals[k][j].b;
+                const PlotPoint m{xs[at[k][j]], ys[k][at[k][j]]};
+                points.push_back(m);
+
+                const int finite = std::isfinite(a.y) + std::isfinite(m.y) + std::isfinite(b.y);
+                bool split;
+                if (finite == 0) {
+                    split = false;
+                } else if (finite < 3) {
+                    // межа області визначення: уточнюємо, де саме обривається лінія
+                    split = true;
+                } else {
+                    const double pa = view.toPixelY(a.y);
+                    const double pm = view.toPixelY(m.y);
+                    const double pb = view.toPixelY(b.y);
+                    const bool above = pa < 0 && pm < 0 && pb < 0;
+                    const bool below = pa > view.height && pm > view.height && pb > view.height;
+                    split = !above && !below && std::abs(pm - (pa + pb) / 2) > TolerancePx;
+
+                    if (split && depth == MaxDepth) {
+                        // на субпіксельному інтервалі гладка функція вже не відхиляється,
+                        // тож це стрибок чи асимптота: рвемо лінію на більшому перепаді
+                        double breakX = std::abs(pm - pa) > std::abs(pb - pm) ? (a.x + m.x) / 2 : (m.x + b.x) / 2;
+                        points.push_back({breakX, nan});
+                        split = false;
+                    }
+                }
+
+                if (split && depth < MaxDepth) {
+                    next.push_back({a, m});
+                    next.push_back({m, b});
+                }
+            }
+            intervals[k] = std::move(next);
+        }
+    }
+
+    for (auto& points : curves)
+        std::sort(points.begin(), points.end(), [](const PlotPoint& l, const PlotPoint& r) { return l.x < r.x; });
+    return curves;
+}
+
+PlotCurves Sampler::adaptive(const PlotView& view) {
+    return refine(view, grid(view));
+}
+
+std::vector<PlotPoint> Sampler::parametric(const PlotView& view, double tMin, double tMax,
+                                           bool refine, std::exception_ptr* failure) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    struct Sample
+    {
+        double t;
+        PlotPoint p;
+    };
+
+    // x(t) і y(t) обчислюються одним пакетом у тих самих t
+    std::vector<std::exception_ptr> errors;
+    auto sample = [&](const std::vector<double>& ts) {
+        std::vector<double> xs(ts.size());
+        std::vector<double> ys(ts.size());
+        double* out[] = {xs.data(), ys.data()};
+        evaluate(ts.data(), out, ts.size(), nullptr, &errors);
+
+        std::vector<Sample> samples(ts.size());
+        for (size_t i = 0; i < ts.size(); ++i) {
+            const bool finite = std::isfinite(xs[i]) && std::isfinite(ys[i]);
+            samples[i] = {ts[i], {finite ? xs[i] : nan, finite ? ys[i] : nan}};
+        }
+        return samples;
+    };
+    auto pixel = [&](const PlotPoint& p) { return PlotPoint{view.toPixelX(p.x), view.toPixelY(p.y)}; };
+
+    std::vector<double> ts(ParametricSteps + 1);
+    for (size_t i = 0; i <= ParametricSteps; ++i)
+        ts[i] = tMin + (tMax - tMin) * i / ParametricSteps;
+    std::vector<Sample> points = sample(ts);
+
+    if (std::none_of(points.begin(), points.end(), [](const Sample& s) { return std::isfinite(s.p.y); })) {
+        for (const std::exception_ptr& error : errors) {
+            if (!error)
+                continue;
+            if (!failure)
+                std::rethrow_exception(error);
+            *failure = error;
+            break;
+        }
+    }
+
+    std::vector<std::pair<Sample, Sample>> intervals;
+    if (refine)
+        for (size_t i = 1; i < points.size(); ++i)
+            intervals.push_back({points[i - 1], points[i]});
+
+    for (int depth = 1; depth <= ParametricDepth && !intervals.empty(); ++depth) {
+        std::vector<double> middles(intervals.size());
+        for (size_t j = 0; j < intervals.size(); ++j)
+            middles[j] = (intervals[j].first.t + intervals[j].second.t) / 2;
+        const std::vector<Sample> sampled = sample(middles);
+
+        std::vector<std::pair<Sample, Sample>> next;
+        for (size_t j = 0; j < intervals.size(); ++j) {
+            const Sample& a = intervals[j].first;
+            const Sample& b = intervals[j].second;
+            const Sample& m = sampled[j];
+            points.push_back(m);
+
+            const PlotPoint pa = pixel(a.p);
+            const PlotPoint pm = pixel(m.p);
+            const PlotPoint pb = pixel(b.p);
+            const int finite = std::isfinite(a.p.y) + std::isfinite(m.p.y) + std::isfinite(b.p.y);
+            bool split;
+            if (finite == 0) {
+                split = false;
+            } else if (finite < 3) {
+                // межа області визначення, якщо вона видима
+                split = nearView(view, {pa, pm, pb});
+            } else {
+                split = nearView(view, {pa, pm, pb}) && distanceToChord(pm, pa, pb) > TolerancePx;
+                if (split && depth == ParametricDepth) {
+                    // як і в refine: крива, що не згладилась, тут розривається
+                    const bool first = std::hypot(pm.x - pa.x, pm.y - pa.y) > std::hypot(pb.x - pm.x, pb.y - pm.y);
+                    points.push_back({first ? (a.t + m.t) / 2 : (m.t + b.t) / 2, {nan, nan}});
+                    split = false;
+                }
+            }
+
+            if (split) {
+                next.push_back({a, m});
+                next.push_back({m, b});
+            }
+        }
+        intervals = std::move(next);
+    }
+    std::sort(points.begin(), points.end(), [](const Sample& l, const Sample& r) { return l.t < r.t; });
+
+    // лишаються лише відрізки поблизу view, решта розриває лінію
+    std::vector<PlotPoint> curve;
+    bool open = false;
+    for (size_t i = 1; i < points.size(); ++i) {
+        const PlotPoint& a = points[i - 1].p;
+        const PlotPoint& b = points[i].p;
+        if (!std::isfinite(a.y) || !std::isfinite(b.y) || !nearView(view, {pixel(a), pixel(b)})) {
+            open = false;
+            continue;
+        }
+        if (!open) {
+            if (!curve.empty())
+                curve.push_back({nan, nan});
+            curve.push_back(a);
+            open = true;
+        }
+        curve.push_back(b);
+    }
+    return curve;
+}
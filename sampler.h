@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "evaluator.h"
+#include "kernel.h"
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Видима область графіка: межі в координатах функції та розмір у пікселях
+struct PlotView
+{
+    double xMin;
+    double xMax;
+    double yMin;
+    double yMax;
+    int width;
+    int height;
+
+    double toPixelX(double x) const;
+    double toPixelY(double y) const;
+};
+
+// Вибірку перервано умовою Sampler::setCancel; її результат відкидається
+struct SamplingCancelled : std::exception
+{
+    const char* what() const noexcept override { return "sampling cancelled"; }
+};
+
+// Точка кривої; y = NaN розриває лінію
+struct PlotPoint
+{
+    double x;
+    double y;
+};
+
+// Криві кількох функцій: curves[k] - точки k-ї функції
+using PlotCurves = std::vector<std::vector<PlotPoint>>;
+
+// Що малює графік
+struct PlotSpec
+{
+    enum class Kind {
+        Explicit,    // y = f(x) для кожної з functions
+        Parametric,  // (x(t), y(t)) для t з [tMin, tMax]: functions = {x, y}
+        Implicit     // f(x, y) = 0: functions = {f}
+    };
+
+    Kind kind = Kind::Explicit;
+    std::vector<std::shared_ptr<Lambda>> functions;
+    double tMin = 0;
+    double tMax = 0;
+
+    // кількість кривих на полотні: у Parametric та Implicit - одна
+    size_t curveCount() const;
+};
+
+// Обчислює функції одного аргументу в наборі точок паралельно на ThreadPool.
+// Кілька функцій обчислюються за один прохід у тих самих x: числові лямбди -
+// одним спільним Kernel (спільні підвирази рахуються раз), решта -
+// інтерпретатором. Кожен шматок точок обчислюється власним Evaluator (свій
+// стек VM і свої кадри), спільним для всіх функцій; глобальне середовище лише
+// читається, тож під час вибірки його ніхто не змінює.
+class Sampler
+{
+public:
+    Sampler(Evaluator& eval, std::vector<std::shared_ptr<Lambda>> functions);
+
+    size_t size() const;
+
+    // Умова перевіряється перед кожним шматком точок, з різних потоків; якщо
+    // вона справдилася, вибірка кидає SamplingCancelled
+    void setCancel(std::function<bool()> cancelled);
+
+    // ys[k][i] = functions[k](xs[i]); нечисловий чи нескінченний результат дає NaN.
+    // Якщо задано wanted, k-та функція обчислюється лише там, де wanted[k][i]
+    // (wanted[k] == nullptr - всюди), а в решті точок ys[k][i] довільне.
+    // Помилка обчислення прокидається для найменшого x, на якому вона сталася.
+    // Якщо передано pointErrors, точка з помилкою теж дає NaN, обчислення решти
+    // триває, а перша за x помилка k-ї функції записується в (*pointErrors)[k].
+    void evaluate(const double* xs, double* const* ys, size_t n,
+                  const bool* const* wanted = nullptr, std::vector<std::exception_ptr>* pointErrors = nullptr);
+
+    // Груба сітка view з кроком у кілька пікселів, від xMin до xMax включно,
+    // спільна для всіх функцій. Точка з помилкою дає NaN; помилка прокидається,
+    // лише якщо якась функція не обчислилася в жодній точці сітки. Якщо
+    // передано failures, така помилка k-ї функції лише записується в
+    // (*failures)[k], а решта кривих лишається.
+    PlotCurves grid(const PlotView& view, std::vector<std::exception_ptr>* failures = nullptr);
+
+    // Уточнює grid для view: інтервали, де середня точка відхиляється від хорди
+    // більше ніж на пів пікселя, діляться навпіл. Кожен рівень поділу всіх
+    // функцій обчислюється одним пакетом через evaluate. Інтервал, що не
+    // згладився й на найдрібнішому рівні, вважається розривом чи асимптотою, і
+    // лінія на ньому переривається; точка з помилкою теж розриває лінію.
+    // Точки кожної кривої впорядковані за x.
+    PlotCurves refine(const PlotView& view, PlotCurves grid);
+
+    // refine(view, grid(view))
+    PlotCurves adaptive(const PlotView& view);
+
+    // Крива (x(t), y(t)) з functions = {x, y}: рівномірна сітка t, інтервали якої
+    // діляться навпіл, поки середня точка відхиляється від хорди більше ніж на
+    // пів пікселя. Уточнюються й повертаються лише відрізки поблизу view, тож
+    // при великому масштабі точок не більше, ніж видно. Точки впорядковані за
+    // t; точка з y = NaN розриває лінію. Помилка - як у grid: лише якщо крива
+    // не обчислилася в жодній точці сітки, і якщо передано failure, вона лише
+    // записується туди.
+    std::vector<PlotPoint> parametric(const PlotView& view, double tMin, double tMax,
+                                      bool refine = true, std::exception_ptr* failure = nullptr);
+
+private:
+    Evaluator::Backend backend;
+    std::vector<std::shared_ptr<Lambda>> functions;
+    std::unique_ptr<Kernel> kernel; // nullptr - усі функції обчислює інтерпретатор
+    std::function<bool()> cancelled;
+};
+
+#endif // SAMPLER_H
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "symboltable.h"
+
+SymbolTable::SymbolTable() {
+    // порядок має збігатися з переліком Sym
+    for (const char* name : {"LAMBDA", "DEFINE", "BEGIN", "COND", "ELSE", "AND", "OR"}) {
+        names.emplace_back(name);
+        ids.emplace(names.back(), static_cast<Symbol>(names.size() - 1));
+    }
+}
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+    SymbolTable& table = instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    auto it = table.ids.find(name);
+    if (it != table.ids.end())
+        return it->second;
+
+    table.names.emplace_back(name);
+    Symbol id = static_cast<Symbol>(table.names.size() - 1);
+    table.ids.emplace(table.names.back(), id);
+    return id;
+}
+
+const std::string& SymbolTable::name(Symbol id) {
+    SymbolTable& table = instance();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return table.names.at(id);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using Symbol = std::uint32_t;
+
+// Службові символи інтернуються першими, тому їхні ID відомі під час компіляції
+namespace Sym {
+enum : Symbol {
+    LAMBDA,
+    DEFINE,
+    BEGIN,
+    COND,
+    ELSE,
+    AND,
+    OR,
+    Count,
+    None = static_cast<Symbol>(-1) // атом, що не є символом
+};
+}
+
+// Глобальна таблиця символів: кожен ідентифікатор (вже у верхньому регістрі)
+// зберігається один раз і отримує компактний цілочисельний ID.
+class SymbolTable
+{
+public:
+    static Symbol intern(std::string_view name);
+    static const std::string& name(Symbol id);
+
+private:
+    SymbolTable();
+    static SymbolTable& instance();
+
+    std::mutex mutex;
+    std::unordered_map<std::string_view, Symbol> ids;
+    std::deque<std::string> names;
+};
+
+#endif // SYMBOLTABLE_H
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоків на всі ядра процесора, спільний для всієї програми.
+// parallelFor роздає індекси задач потокам пулу; викликаючий потік теж
+// виконує задачі, тож на одноядерній машині все виконується послідовно.
+class ThreadPool
+{
+public:
+    static ThreadPool& instance();
+
+    // кількість потоків, що виконують задачі, разом із викликаючим
+    size_t size() const;
+
+    // Виконує task(i) для кожного i з [0, count) і чекає завершення.
+    // Виняток першої задачі, що впала, прокидається після завершення решти.
+    // Виклик зсередини задачі виконується послідовно в тому ж потоці.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    explicit ThreadPool(size_t workers);
+    ~ThreadPool();
+
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> threads;
+    std::mutex batchMutex;  // одночасно виконується лише один parallelFor
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)>* task = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> next{0};
+    size_t active = 0;
+    std::uint64_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    static thread_local bool insideTask;
+};
+
+#endif // THREADPOOL_H
@@ -1,170 +1,178 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#include "utils.h"
-#include "evaluator.h"
-#include <regex>
-
-std::vector<std::string> tokenizeLisp(const std::string& input) {
-    std::vector<std::string> tokens;
-
-    std::regex token_regex(R"((\()|(\))|(\"[^\"]*\")|([^\s()]+))");
-    std::smatch match;
-    std::string s = input;
-
-    while (std::regex_search(s, match, token_regex)) {
-        tokens.push_back(match.str());
-        s = match.suffix();
-    }
-
-    return tokens;
-}
-
-bool isNumber(std::shared_ptr<ListObject> exp) {
-    if (!exp->isAtom())
-        return false;
-
-    std::string token = exp->asAtom();
-    // Дозволяє: -12, 3.14, -0.001, 42
-    std::regex number_regex(R"(^-?[0-9]+(\.[0-9]+)?$)");
-    return std::regex_match(token, number_regex);
-}
-
-
-bool isBoolean(std::shared_ptr<ListObject> exp) {
-    if (!exp->isAtom())
-        return false;
-
-    std::string token = exp->asAtom();
-    if (token == "TRUE" || token == "FALSE")
-        return true;
-    else
-        return false;
-}
-
-bool isString(std::shared_ptr<ListObject> exp) {
-    if (!exp->isAtom())
-        return false;
-
-    std::string token = exp->asAtom();
-    if (token[0] == '"' && token[token.size() - 1] == '"')
-        return true;
-    else
-        return false;
-
-}
-
-bool isVariable(std::shared_ptr<ListObject> exp, std::shared_ptr<Environment> env) {
-    if (!exp->isAtom())
-        return false;
-
-    if (env->has(exp->asAtom()))
-        return true;
-
-    return false;
-}
-
-bool isLambda(std::shared_ptr<ListObject> exp) {
-    if (!exp->isAtom()) {
-        auto token = exp->asList();
-
-        // lambda має мінімум 3 частини: 'lambda', аргументи, тіло
-        if (token.size() < 3)
-            return false;
-
-        // перший елемент має бути атомом "lambda"
-        if (!token[0]->isAtom() || token[0]->asAtom() != "LAMBDA")
-            return false;
-
-        // другий елемент має бути списком параметрів
-        if (token[1]->isAtom())
-            return false;
-
-        for (const auto& param : token[1]->asList()) {
-            if (!param->isAtom()) {
-                std::cerr << "Lambda param is not atom!\n";
-                return false;
-            }
-        }
-
-        // все валідно
-        return true;
-    }
-    return false;
-}
-
-
-bool isApplication(std::shared_ptr<ListObject> exp, std::shared_ptr<Environment> env, Evaluator& eval) {
-    if (exp->isAtom())
-        return false;
-
-    const auto& list = exp->asList();
-    if (list.empty())
-        return false;
-
-    try {
-        if (list[0]->isAtom() && eval.isPrimitive(list[0]->asAtom()))
-            return true;
-
-        Value first = eval.Eval(list[0], env);
-        return first.isLambda();
-    } catch (...) {
-        return false;
-    }
-}
-
-Value ensureSingleTypeAndCompare(const std::vector<Value>& vals, std::function<bool(long double, long double)> cmp) {
-    for (const auto& val : vals)
-        if (!val.isNumber())
-            throw std::runtime_error("Comparison requires numeric arguments");
-
-    for (size_t i = 1; i < vals.size(); ++i)
-        if (!cmp(vals[i - 1].asNumber(), vals[i].asNumber()))
-            return Value(false);
-
-    return Value(true);
-}
-
-bool areParenthesesBalanced(const std::string& input) {
-    int openCount = 0;
-    bool inString = false;
-
-    for (size_t i = 0; i < input.length(); ++i) {
-        char ch = input[i];
-
-        if (ch == '"' && (i == 0 || input[i - 1] != '\\')) {
-            inString = !inString;
-        }
-
-        if (!inString) {
-            if (ch == '(') {
-                openCount++;
-            } else if (ch == ')') {
-                openCount--;
-                if (openCount < 0) {
-                    return false;
-                }
-            }
-        }
-    }
-
-    return openCount == 0;
-}
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "utils.h"
+#include "astarena.h"
+#include "constantfolder.h"
+#include "evaluator.h"
+#include "resolver.h"
+#include "tokenstream.h"
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+std::vector<Token> tokenizeLisp(std::string_view input) {
+    return Lexer(input).tokenize();
+}
+
+bool isNumber(const ListObject* exp) {
+    return exp->isAtom() && exp->atomType() == ListObject::AtomType::Number;
+}
+
+bool isBoolean(const ListObject* exp) {
+    return exp->isAtom() && exp->atomType() == ListObject::AtomType::Boolean;
+}
+
+bool isString(const ListObject* exp) {
+    return exp->isAtom() && exp->atomType() == ListObject::AtomType::String;
+}
+
+bool isVariable(const ListObject* exp, std::shared_ptr<Environment> env) {
+    if (!exp->isAtom() || exp->atomType() != ListObject::AtomType::Symbol)
+        return false;
+
+    return env->has(exp->asSymbol());
+}
+
+bool isLambda(const ListObject* exp) {
+    if (!exp->isAtom()) {
+        const auto& token = exp->asList();
+
+        // lambda має мінімум 3 частини: 'lambda', аргументи, тіло
+        if (token.size() < 3)
+            return false;
+
+        // перший елемент має бути атомом "lambda"
+        if (!token[0]->isAtom() || token[0]->asSymbol() != Sym::LAMBDA)
+            return false;
+
+        // другий елемент має бути списком параметрів
+        if (token[1]->isAtom())
+            return false;
+
+        for (const auto& param : token[1]->asList()) {
+            if (!param->isAtom()) {
+                std::cerr << "Lambda param is not atom!\n";
+                return false;
+            }
+        }
+
+        // все валідно
+        return true;
+    }
+    return false;
+}
+
+bool isBegin(const ListObject* exp) {
+    if (exp->isAtom())
+        return false;
+
+    const auto& list = exp->asList();
+    return !list.empty() && list[0]->isAtom() && list[0]->asSymbol() == Sym::BEGIN;
+}
+
+bool isCond(const ListObject* exp) {
+    if (exp->isAtom())
+        return false;
+
+    const auto& list = exp->asList();
+    return !list.empty() && list[0]->isAtom() && list[0]->asSymbol() == Sym::COND;
+}
+
+bool areParenthesesBalanced(const std::string& input) {
+    int openCount = 0;
+    bool inString = false;
+
+    for (size_t i = 0; i < input.length(); ++i) {
+        char ch = input[i];
+
+        if (ch == '"' && (i == 0 || input[i - 1] != '\\')) {
+            inString = !inString;
+        }
+
+        if (!inString) {
+            if (ch == '(') {
+                openCount++;
+            } else if (ch == ')') {
+                openCount--;
+                if (openCount < 0) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return openCount == 0;
+}
+
+void evalSource(const std::string& source, std::shared_ptr<Environment> env, Evaluator& eval) {
+    auto tokens = tokenizeLisp(source);
+    TokenStream ts(tokens);
+    // одна арена на все джерело; лямбди з нього тримають її й після виконання
+    auto arena = std::make_shared<AstArena>();
+
+    // джерело розбирається повністю до виконання: згортанню констант треба
+    // бачити всі його DEFINE. Помилка розбору кидається після виконання
+    // форм перед нею, як і раніше
+    std::vector<ListObject*> forms;
+    std::exception_ptr parseError;
+    try {
+        while (ts.hasNext())
+            forms.push_back(ListObject::parse_tokens(ts, *arena));
+    } catch (const std::exception&) {
+        parseError = std::current_exception();
+    }
+
+    if (eval.getFolding() != Evaluator::Folding::Off)
+        ConstantFolder(eval, *arena).fold(forms, eval.getFolding() == Evaluator::Folding::Report ? &std::cout : nullptr);
+
+    for (ListObject* exp : forms) {
+        Resolver::resolve(exp, arena);
+        eval.Eval(exp, env);
+    }
+
+    if (parseError)
+        std::rethrow_exception(parseError);
+}
+
+void evalFile(const std::string& path, std::shared_ptr<Environment> env, Evaluator& eval) {
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (!file) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+
+    std::string content;
+    content.resize(size);
+    size_t readBytes = fread(&content[0], 1, size, file);
+    fclose(file);
+
+    if (readBytes != (size_t)size) {
+        throw std::runtime_error("Error reading file: " + path);
+    }
+
+    evalSource(content, env, eval);
+}
@@ -1,56 +1,239 @@
-/*
- * Copyright (c) 2025 Matvii Jarosh
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- * THE SOFTWARE.
-*/
-#ifndef VALUE_H
-#define VALUE_H
-
-#include "lambda.h"
-
-class Value
-{
-public:
-    using VariantType = std::variant<long double, std::string, bool, std::shared_ptr<Lambda>>;
-
-    Value();
-    Value(long double num);
-    Value(const std::string& str);
-    Value(const char* str);
-    Value(bool b);
-    Value(std::shared_ptr<Lambda> lambda);
-
-    bool isNumber() const;
-    bool isString() const;
-    bool isBool() const;
-    bool isLambda() const;
-
-    long double asNumber() const;
-    const std::string& asString() const;
-    bool asBool() const;
-    std::shared_ptr<Lambda> asLambda() const;
-
-    void print(std::ostream& out = std::cout) const;
-    std::string str() const;
-
-private:
-    VariantType data;
-};
-
-#endif // VALUE_H
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef VALUE_H
+#define VALUE_H
+
+#include "lambda.h"
+#include "number.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <variant>
+
+// Значення займає 8 байт (NaN-boxing): число зберігається як double,
+// а TRUE/FALSE і вказівники на рядки та лямбди кодуються в бітах "тихого" NaN.
+// Рядки й лямбди лежать у купі з лічильником посилань, копія Value лише збільшує його.
+// У режимі GRAPHREPL_LONG_DOUBLE у купу потрапляють і числа, які double не передає точно.
+class Value
+{
+public:
+    Value();
+    Value(Number num);
+    Value(const std::string& str);
+    Value(const char* str);
+    Value(bool b);
+    Value(std::shared_ptr<Lambda> lambda);
+
+    Value(const Value& other);
+    Value(Value&& other) noexcept;
+    Value& operator=(const Value& other);
+    Value& operator=(Value&& other) noexcept;
+    ~Value();
+
+    bool isNumber() const;
+    bool isString() const;
+    bool isBool() const;
+    bool isLambda() const;
+
+    // Слот кадру, до якого ще не дійшов DEFINE. Value() - це число 0,
+    // тож пропущені слоти позначаються окремим значенням
+    static Value unbound();
+    bool isUnbound() const;
+
+    Number asNumber() const;
+    const std::string& asString() const;
+    bool asBool() const;
+    std::shared_ptr<Lambda> asLambda() const;
+
+    void print(std::ostream& out = std::cout) const;
+    std::string str() const;
+
+private:
+    static constexpr std::uint64_t SignBit = 0x8000000000000000ULL;
+    static constexpr std::uint64_t QuietNaN = 0x7ffc000000000000ULL;
+    static constexpr std::uint64_t CanonicalNaN = 0x7ff8000000000000ULL;
+    static constexpr std::uint64_t FalseBits = QuietNaN | 1;
+    static constexpr std::uint64_t TrueBits = QuietNaN | 2;
+    static constexpr std::uint64_t UnboundBits = QuietNaN | 3;
+    static constexpr std::uint64_t HeapTag = SignBit | QuietNaN;
+
+    struct HeapObject
+    {
+        enum class Kind : std::uint8_t { String, Lambda, Number };
+
+        HeapObject(Kind kind) : kind(kind) {}
+
+        std::atomic<std::uint32_t> refs{1};
+        Kind kind;
+    };
+
+    struct StringObject : HeapObject
+    {
+        StringObject(std::string value) : HeapObject(Kind::String), value(std::move(value)) {}
+        std::string value;
+    };
+
+    struct LambdaObject : HeapObject
+    {
+        LambdaObject(std::shared_ptr<Lambda> value) : HeapObject(Kind::Lambda), value(std::move(value)) {}
+        std::shared_ptr<Lambda> value;
+    };
+
+    struct NumberObject : HeapObject
+    {
+        NumberObject(Number value) : HeapObject(Kind::Number), value(value) {}
+        Number value;
+    };
+
+    explicit Value(HeapObject* object);
+
+    bool isTagged() const;
+    bool isHeap() const;
+    HeapObject* heap() const;
+    void retain() const;
+    void releaseHeap();
+
+    std::uint64_t bits;
+};
+
+static_assert(sizeof(Value) == 8, "Value must fit in a machine word");
+
+// Копіювання, знищення та перевірки типу викликаються на кожному кроці
+// обчислення, тому вони вбудовані тут, а не у value.cpp
+
+inline Value::Value() : bits(0) {}
+
+inline Value::Value(Number num) {
+    double d = static_cast<double>(num);
+#ifdef GRAPHREPL_LONG_DOUBLE
+    if (num == num && static_cast<Number>(d) != num) {
+        bits = HeapTag | reinterpret_cast<std::uintptr_t>(static_cast<HeapObject*>(new NumberObject(num)));
+        return;
+    }
+#endif
+    if (d != d)
+        bits = CanonicalNaN;
+    else
+        std::memcpy(&bits, &d, sizeof(d));
+}
+
+inline Value::Value(bool b) : bits(b ? TrueBits : FalseBits) {}
+
+inline Value Value::unbound() {
+    Value value;
+    value.bits = UnboundBits;
+    return value;
+}
+
+inline Value::Value(const Value& other) : bits(other.bits) {
+    retain();
+}
+
+inline Value::Value(Value&& other) noexcept : bits(other.bits) {
+    other.bits = 0;
+}
+
+inline Value& Value::operator=(const Value& other) {
+    if (this != &other) {
+        other.retain();
+        releaseHeap();
+        bits = other.bits;
+    }
+    return *this;
+}
+
+inline Value& Value::operator=(Value&& other) noexcept {
+    if (this != &other) {
+        releaseHeap();
+        bits = other.bits;
+        other.bits = 0;
+    }
+    return *this;
+}
+
+inline Value::~Value() {
+    releaseHeap();
+}
+
+inline bool Value::isTagged() const { return (bits & QuietNaN) == QuietNaN; }
+inline bool Value::isBool() const { return bits == TrueBits || bits == FalseBits; }
+inline bool Value::isHeap() const { return (bits & HeapTag) == HeapTag; }
+inline bool Value::isUnbound() const { return bits == UnboundBits; }
+
+#ifdef GRAPHREPL_LONG_DOUBLE
+inline bool Value::isNumber() const { return !isTagged() || (isHeap() && heap()->kind == HeapObject::Kind::Number); }
+#else
+inline bool Value::isNumber() const { return !isTagged(); }
+#endif
+
+inline bool Value::isString() const { return isHeap() && heap()->kind == HeapObject::Kind::String; }
+inline bool Value::isLambda() const { return isHeap() && heap()->kind == HeapObject::Kind::Lambda; }
+
+inline Number Value::asNumber() const {
+    if (!isNumber())
+        throw std::bad_variant_access();
+#ifdef GRAPHREPL_LONG_DOUBLE
+    if (isHeap())
+        return static_cast<NumberObject*>(heap())->value;
+#endif
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+inline bool Value::asBool() const {
+    if (!isBool())
+        throw std::bad_variant_access();
+    return bits == TrueBits;
+}
+
+inline Value::HeapObject* Value::heap() const {
+    return reinterpret_cast<HeapObject*>(static_cast<std::uintptr_t>(bits & ~HeapTag));
+}
+
+inline void Value::retain() const {
+    if (isHeap())
+        heap()->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void Value::releaseHeap() {
+    if (!isHeap())
+        return;
+
+    HeapObject* object = heap();
+    if (object->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    switch (object->kind) {
+    case HeapObject::Kind::String:
+        delete static_cast<StringObject*>(object);
+        break;
+    case HeapObject::Kind::Lambda:
+        delete static_cast<LambdaObject*>(object);
+        break;
+    case HeapObject::Kind::Number:
+        delete static_cast<NumberObject*>(object);
+        break;
+    }
+}
+
+#endif // VALUE_H
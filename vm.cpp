@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#include "vm.h"
+#include "compiler.h"
+#include "environment.h"
+#include "evaluator.h"
+#include "utils.h"
+
+Value VM::run(const std::shared_ptr<const Chunk>& chunk, std::shared_ptr<Environment> env, Evaluator& eval) {
+    size_t entryDepth = frames.size();
+    frames.push_back({chunk, chunk->code.data(), std::move(env)});
+    return guarded(entryDepth, eval);
+}
+
+Value VM::call(const std::shared_ptr<Lambda>& lambda, const std::vector<Value>& args, Evaluator& eval) {
+    size_t entryDepth = frames.size();
+    pushCall(lambda, args.data(), args.size(), eval);
+    return guarded(entryDepth, eval);
+}
+
+Value VM::eval(ListObject* exp, std::shared_ptr<Environment> env, Evaluator& eval) {
+    for (size_t i = 0; i < lazy.nodes.size(); ++i)
+        if (lazy.nodes[i] == exp)
+            return run(lazy.code[i], std::move(env), eval);
+    return run(Compiler(eval).compile(exp), std::move(env), eval);
+}
+
+// після помилки стек і кадри повертаються до стану на вході,
+// щоб VM можна було використовувати далі (зокрема при вкладених викликах)
+Value VM::guarded(size_t entryDepth, Evaluator& eval) {
+    size_t entryStack = stack.size();
+    try {
+        return execute(entryDepth, eval);
+    } catch (...) {
+        frames.resize(entryDepth);
+        stack.resize(entryStack);
+        throw;
+    }
+}
+
+void VM::pushCall(const std::shared_ptr<Lambda>& lambda, const Value* args, size_t argc, Evaluator& eval) {
+    const auto& params = lambda->getArgs();
+    if (argc < params.size())
+        throw std::runtime_error("Lambda expects " + std::to_string(params.size()) + " arguments, got " + std::to_string(argc));
+
+    auto newEnv = std::make_shared<Environment>(lambda->getEnv(), lambda->getFrame());
+    for (size_t i = 0; i < params.size(); ++i)
+        newEnv->defineSlot(i, args[i]);
+
+    auto code = lambda->getCode([&] { return Compiler(eval).compileBody(*lambda); });
+    const std::uint32_t* ip = code->code.data();
+    frames.push_back({std::move(code), ip, std::move(newEnv)});
+}
+
+Value VM::execute(size_t entryDepth, Evaluator& eval) {
+    Frame* frame = &frames.back();
+    const std::uint32_t* ip = frame->ip;
+
+    for (;;) {
+        OpCode op = static_cast<OpCode>(*ip++);
+        switch (op) {
+        case OpCode::Const:
+            stack.push_back(frame->chunk->constants[*ip++]);
+            break;
+
+        case OpCode::Local: {
+            int depth = static_cast<int>(*ip++);
+            int slot = static_cast<int>(*ip++);
+            stack.push_back(frame->env->lookup(depth, slot));
+            break;
+        }
+
+        case OpCode::Global:
+            stack.push_back(frame->env->get(*ip++));
+            break;
+
+        case OpCode::DefineLocal:
+            frame->env->defineSlot(static_cast<int>(*ip++), stack.back());
+            break;
+
+        case OpCode::DefineGlobal:
+            frame->env->define(*ip++, stack.back());
+            break;
+
+        case OpCode::Pop:
+            stack.pop_back();
+            break;
+
+        case OpCode::Jump:
+            ip = frame->chunk->code.data() + *ip;
+            break;
+
+        case OpCode::JumpIfFalse: {
+            std::uint32_t target = *ip++;
+            const Value& value = stack.back();
+            bool jump = value.isBool() && !value.asBool();
+            stack.pop_back();
+            if (jump)
+                ip = frame->chunk->code.data() + target;
+            break;
+        }
+
+        case OpCode::JumpIfTrue: {
+            std::uint32_t target = *ip++;
+            const Value& value = stack.back();
+            bool jump = value.isBool() && value.asBool();
+            stack.pop_back();
+            if (jump)
+                ip = frame->chunk->code.data() + target;
+            break;
+        }
+
+        case OpCode::EnterFrame: {
+            const auto& form = frame->chunk->nodes[*ip++];
+            frame->env = std::make_shared<Environment>(frame->env, form->frame());
+            break;
+        }
+
+        case OpCode::LeaveFrame: {
+            auto parent = frame->env->getParent();
+            frame->env = std::move(parent);
+            break;
+        }
+
+        case OpCode::Closure:
+            stack.push_back(Value(eval.MakeLambda(frame->chunk->nodes[*ip++], frame->env)));
+            break;
+
+        case OpCode::Call: {
+            size_t argc = *ip++;
+            size_t base = stack.size() - argc - 1;
+            if (!stack[base].isLambda())
+                throw std::runtime_error("No found type");
+
+            auto lambda = stack[base].asLambda();
+            frame->ip = ip;
+            pushCall(lambda, stack.data() + base + 1, argc, eval);
+            stack.resize(base);
+
+            frame = &frames.back();
+            ip = frame->ip;
+            break;
+        }
+
+        case OpCode::TailCall: {
+            size_t argc = *ip++;
+            size_t base = stack.size() - argc - 1;
+            if (!stack[base].isLambda())
+                throw std::runtime_error("No found type");
+
+            // новий кадр стає на місце поточного, тож хвостова рекурсія не нарощує кадри VM
+            auto lambda = stack[base].asLambda();
+            frames.pop_back();
+            pushCall(lambda, stack.data() + base + 1, argc, eval);
+            stack.resize(base);
+
+            frame = &frames.back();
+            ip = frame->ip;
+            break;
+        }
+
+        case OpCode::Builtin: {
+            const auto& primitive = eval.getPrimitive(*ip++);
+            size_t argc = *ip++;
+            size_t base = stack.size() - argc;
+            // кількість аргументів перевірив компілятор
+            primitive.checkTypes(stack.data() + base, argc);
+            Value result = primitive.strict(stack.data() + base, argc);
+            stack.resize(base);
+            stack.push_back(std::move(result));
+            break;
+        }
+
+        case OpCode::Primitive: {
+            const auto& form = frame->chunk->nodes[*ip++];
+            const auto list = form->asList();
+            const auto* arguments = frame->chunk->arguments.data() + *ip++;
+
+            // кадр копіюється: вкладений виклик VM може перемістити вектор кадрів;
+            // копія chunk тримає байткод аргументів
+            frame->ip = ip;
+            auto env = frame->env;
+            auto chunk = frame->chunk;
+
+            struct Restore
+            {
+                LazyArguments& lazy;
+                LazyArguments saved;
+                ~Restore() { lazy = saved; }
+            } restore{lazy, lazy};
+            lazy = {list.from(1), arguments};
+            Value result = eval.getPrimitive(list[0]->asSymbol()).lazy(list.from(1), env, eval);
+
+            // примітив міг знову викликати VM, тому кадр беремо заново
+            frame = &frames.back();
+            stack.push_back(std::move(result));
+            break;
+        }
+
+        case OpCode::Fail:
+            throw std::runtime_error(frame->chunk->constants[*ip].asString());
+
+        case OpCode::Return: {
+            Value result = std::move(stack.back());
+            stack.pop_back();
+            frames.pop_back();
+            if (frames.size() == entryDepth)
+                return result;
+
+            stack.push_back(std::move(result));
+            frame = &frames.back();
+            ip = frame->ip;
+            break;
+        }
+        }
+    }
+}
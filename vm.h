@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Matvii Jarosh
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+*/
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include <vector>
+
+class Environment;
+class Evaluator;
+
+// Стекова віртуальна машина для байткоду з Compiler.
+// Кадри викликів використовують ті самі масивні кадри Environment,
+// що й Evaluator, тож обидва бекенди бачать однакові змінні.
+class VM
+{
+public:
+    Value run(const std::shared_ptr<const Chunk>& chunk, std::shared_ptr<Environment> env, Evaluator& eval);
+    Value call(const std::shared_ptr<Lambda>& lambda, const std::vector<Value>& args, Evaluator& eval);
+    // Evaluator::Eval у режимі VM: аргумент лінивого примітиву, що зараз
+    // виконується, бере готовий байткод, інший вираз компілюється
+    Value eval(ListObject* exp, std::shared_ptr<Environment> env, Evaluator& eval);
+
+private:
+    struct Frame
+    {
+        std::shared_ptr<const Chunk> chunk;
+        const std::uint32_t* ip;
+        std::shared_ptr<Environment> env;
+    };
+
+    Value execute(size_t entryDepth, Evaluator& eval);
+    Value guarded(size_t entryDepth, Evaluator& eval);
+    void pushCall(const std::shared_ptr<Lambda>& lambda, const Value* args, size_t argc, Evaluator& eval);
+
+    // аргументи лінивого примітиву, який виконується, і їх байткод
+    struct LazyArguments
+    {
+        ListObject::List nodes;
+        const std::shared_ptr<const Chunk>* code = nullptr;
+    };
+
+    std::vector<Value> stack;
+    std::vector<Frame> frames;
+    LazyArguments lazy;
+};
+
+#endif // VM_H